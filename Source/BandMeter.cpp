@@ -0,0 +1,108 @@
+#include "BandMeter.h"
+
+void BandMeter::prepare(double sampleRate) {
+  // juce::dsp::StateVariableTPTFilter's default resonance (1 / sqrt(2))
+  const float k = juce::MathConstants<float>::sqrt2;
+  const float cutoffs[] = {300.0f, 1000.0f, 5000.0f};
+
+  for (size_t lane = 0; lane < Vec::SIMDNumElements; ++lane) {
+    const float fc = cutoffs[juce::jmin((size_t)2, lane)];
+    const float g = std::tan(juce::MathConstants<float>::pi * fc /
+                             (float)sampleRate);
+    const float c1 = 1.0f / (1.0f + g * (g + k));
+    a1.set(lane, c1);
+    a2.set(lane, g * c1);
+    a3.set(lane, g * g * c1);
+
+    // out = mixX * x + mixBand * v1 + mixLow * v2
+    const bool isHigh = lane == 2;
+    mixX.set(lane, isHigh ? 1.0f : 0.0f);
+    mixBand.set(lane, lane == 1 ? 1.0f : (isHigh ? -k : 0.0f));
+    mixLow.set(lane, lane == 0 ? 1.0f : (isHigh ? -1.0f : 0.0f));
+  }
+
+  windowSamples = juce::jmax(1, (int)(sampleRate / displayRateHz));
+  reset();
+}
+
+void BandMeter::reset() {
+  ic1eq = Vec::expand(0.0f);
+  ic2eq = Vec::expand(0.0f);
+  sumSquares = Vec::expand(0.0f);
+  accumulated = 0;
+  publish({});
+}
+
+void BandMeter::process(const juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  if (buffer.getNumChannels() == 0 || numSamples == 0)
+    return;
+
+  const auto *left = buffer.getReadPointer(0);
+  const auto *right =
+      buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : left;
+
+  // Locals so the loop runs in registers
+  auto s1 = ic1eq, s2 = ic2eq, sum = sumSquares;
+  int pos = 0;
+
+  while (pos < numSamples) {
+    const int n = juce::jmin(numSamples - pos, windowSamples - accumulated);
+
+    for (int i = pos; i < pos + n; ++i) {
+      const auto x = Vec::expand(0.5f * (left[i] + right[i]));
+      const auto v3 = x - s2;
+      const auto v1 = a1 * s1 + a2 * v3;
+      const auto v2 = s2 + a2 * s1 + a3 * v3;
+      s1 = v1 * 2.0f - s1;
+      s2 = v2 * 2.0f - s2;
+
+      const auto y = mixX * x + mixBand * v1 + mixLow * v2;
+      sum += y * y;
+    }
+
+    pos += n;
+    accumulated += n;
+
+    if (accumulated >= windowSamples) {
+      const float scale = 1.0f / (float)accumulated;
+      publish({std::sqrt(sum.get(0) * scale) * meterGain,
+               std::sqrt(sum.get(1) * scale) * meterGain,
+               std::sqrt(sum.get(2) * scale) * meterGain});
+      sum = Vec::expand(0.0f);
+      accumulated = 0;
+    }
+  }
+
+  ic1eq = s1;
+  ic2eq = s2;
+  sumSquares = sum;
+}
+
+void BandMeter::publish(const Levels &levels) {
+  const auto seq = sequence.load(std::memory_order_relaxed);
+  sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  publishedLow.store(levels.low, std::memory_order_relaxed);
+  publishedMid.store(levels.mid, std::memory_order_relaxed);
+  publishedHigh.store(levels.high, std::memory_order_relaxed);
+
+  sequence.store(seq + 2, std::memory_order_release);
+}
+
+BandMeter::Levels BandMeter::getLevels() const {
+  Levels levels;
+  juce::uint32 before, after;
+
+  do {
+    before = sequence.load(std::memory_order_acquire);
+    levels.low = publishedLow.load(std::memory_order_relaxed);
+    levels.mid = publishedMid.load(std::memory_order_relaxed);
+    levels.high = publishedHigh.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = sequence.load(std::memory_order_relaxed);
+  } while ((before & 1u) != 0 || before != after);
+
+  return levels;
+}
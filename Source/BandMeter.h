@@ -0,0 +1,58 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/**
+    Three-band (low / mid / high) RMS meter for the Effects tab EQ bars.
+
+    The three analysis filters are the same TPT state-variable filters the old
+    metering used (LP 300 Hz, BP 1 kHz, HP 5 kHz), packed into the lanes of one
+    SIMD register so a single pass over the block runs all of them. Squares
+    are accumulated in the same register and turned into RMS values only once
+    per display period (~30 Hz), not every block.
+
+    No allocation, no copies. The audio thread publishes each result through a
+    sequence lock; the UI reads a consistent snapshot without ever blocking
+    the writer.
+*/
+class BandMeter {
+public:
+  struct Levels {
+    float low = 0.0f, mid = 0.0f, high = 0.0f;
+  };
+
+  void prepare(double sampleRate);
+  void reset();
+
+  // Audio thread. Measures the mono sum of the first two channels.
+  void process(const juce::AudioBuffer<float> &buffer);
+
+  // Any thread
+  Levels getLevels() const;
+
+private:
+  using Vec = juce::dsp::SIMDRegister<float>;
+  static_assert(Vec::SIMDNumElements >= 3, "Need one lane per band");
+
+  static constexpr float displayRateHz = 30.0f;
+  static constexpr float meterGain = 5.0f; // Filtered bands read quiet
+
+  void publish(const Levels &levels);
+
+  // Per-lane filter coefficients and output mix (lane 0 = low, 1 = mid,
+  // 2 = high; any further lanes are unused)
+  Vec a1{}, a2{}, a3{};
+  Vec mixX{}, mixBand{}, mixLow{};
+
+  // Filter state and the running sum of squares
+  Vec ic1eq{}, ic2eq{};
+  Vec sumSquares{};
+  int accumulated = 0;
+  int windowSamples = 1470; // 44.1 kHz / 30
+
+  // Seqlock: odd while the writer is mid-update
+  std::atomic<juce::uint32> sequence{0};
+  std::atomic<float> publishedLow{0.0f}, publishedMid{0.0f},
+      publishedHigh{0.0f};
+};
@@ -0,0 +1,154 @@
+#include "Bitcrusher.h"
+
+void Bitcrusher::prepare(const juce::dsp::ProcessSpec &spec) {
+  sampleRate = spec.sampleRate;
+  numChannels = juce::jlimit(1, 2, (int)spec.numChannels);
+  bits.prepare(sampleRate, smoothingSeconds);
+  rateHz.prepare(sampleRate, smoothingSeconds);
+  mix.prepare(sampleRate, smoothingSeconds);
+  noise.resize((size_t)spec.maximumBlockSize);
+  mixRamp.resize((size_t)spec.maximumBlockSize);
+  dryBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+  reset();
+}
+
+void Bitcrusher::reset() {
+  state = {};
+  phase = 0.0f;
+
+  // Land on the targets rather than gliding in from stale values
+  updateTargets();
+  bits.snapToTarget();
+  rateHz.snapToTarget();
+  mix.snapToTarget();
+}
+
+void Bitcrusher::updateTargets() {
+  bits.setTarget(juce::jlimit(1.0f, 16.0f, params.bits));
+  rateHz.setTarget(juce::jlimit(50.0f, (float)sampleRate, params.rateHz));
+  mix.setTarget(params.mix);
+}
+
+void Bitcrusher::fillNoise(float *dest, int numSamples) {
+  // TPDF: difference of two uniform values from a cheap LCG, -1 .. 1
+  constexpr float scale = 1.0f / 16777216.0f;
+  for (int i = 0; i < numSamples; ++i) {
+    noiseSeed = noiseSeed * 1664525u + 1013904223u;
+    const float a = (float)(noiseSeed >> 8) * scale;
+    noiseSeed = noiseSeed * 1664525u + 1013904223u;
+    const float b = (float)(noiseSeed >> 8) * scale;
+    dest[i] = a - b;
+  }
+}
+
+void Bitcrusher::quantise(float *data, const float *noiseData,
+                          float ditherGain, float step, int numSamples) {
+  if (noiseData != nullptr)
+    juce::FloatVectorOperations::addWithMultiply(data, noiseData, ditherGain,
+                                                 numSamples);
+
+  // Clip like a converter would; also keeps x * scale well inside the range
+  // where the magic-number rounding is exact
+  juce::FloatVectorOperations::clip(data, data, -1.0f, 1.0f, numSamples);
+
+  // Adding and removing 1.5 * 2^23 rounds to the nearest integer
+  constexpr float magic = 12582912.0f;
+  const float scale = 1.0f / step;
+  for (int i = 0; i < numSamples; ++i)
+    data[i] = ((data[i] * scale + magic) - magic) * step;
+}
+
+void Bitcrusher::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+  if (numSamples == 0 || channels == 0 || noise.empty())
+    return;
+
+  // One smoothing step per block, ramped linearly across it (mix) or held
+  // for the block (bits, rate)
+  updateTargets();
+  bits.next(numSamples);
+  rateHz.next(numSamples);
+  mix.next(numSamples);
+
+  if (mix.getStart() < 1.0e-4f && mix.getEnd() < 1.0e-4f) {
+    idle = true;
+    return; // Fully dry: clean bypass
+  }
+  if (idle) {
+    state = {}; // Start from silence, not a stale hold
+    phase = 0.0f;
+    idle = false;
+  }
+
+  const bool needsDry = mix.getStart() < 1.0f || mix.getEnd() < 1.0f;
+  if (needsDry)
+    for (int ch = 0; ch < channels; ++ch)
+      dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+  // --- Block-rate control ---
+  const float rate = rateHz.getEnd();
+  const float increment = juce::jmin(1.0f, rate / (float)sampleRate);
+  const bool holding = increment < 0.999f;
+  const bool filtering = holding && params.antiAlias;
+
+  // Butterworth low-pass just under the new Nyquist
+  const float cutoff = juce::jmin(0.45f * rate, 0.45f * (float)sampleRate);
+  const float g =
+      std::tan(juce::MathConstants<float>::pi * cutoff / (float)sampleRate);
+  constexpr float k = 1.41421356f;
+  const float a1 = 1.0f / (1.0f + g * (g + k));
+  const float a2 = g * a1;
+  const float a3 = g * a2;
+
+  const float step = std::exp2(1.0f - bits.getEnd()); // 2^bits levels
+  const float ditherGain = juce::jlimit(0.0f, 1.0f, params.dither) * step;
+  const float phaseStart = phase;
+
+  for (int ch = 0; ch < channels; ++ch) {
+    auto *data = buffer.getWritePointer(ch);
+    auto &s = state[(size_t)ch];
+
+    // 1. Anti-alias filter and fractional hold (scalar: both recursive)
+    if (holding) {
+      float p = phaseStart;
+      for (int i = 0; i < numSamples; ++i) {
+        float x = data[i];
+        if (filtering) {
+          const float v3 = x - s.ic2eq;
+          const float v1 = a1 * s.ic1eq + a2 * v3;
+          const float v2 = s.ic2eq + a2 * s.ic1eq + a3 * v3;
+          s.ic1eq = 2.0f * v1 - s.ic1eq;
+          s.ic2eq = 2.0f * v2 - s.ic2eq;
+          x = v2;
+        }
+
+        p += increment;
+        if (p >= 1.0f) {
+          p -= 1.0f;
+          // The hold point fell p / increment samples before this one
+          s.held = x + (s.last - x) * (p / increment);
+        }
+        s.last = x;
+        data[i] = s.held;
+      }
+      phase = p;
+    }
+
+    // 2. Dither and quantise (vector)
+    if (ditherGain > 0.0f)
+      fillNoise(noise.data(), numSamples);
+    quantise(data, ditherGain > 0.0f ? noise.data() : nullptr, ditherGain,
+             step, numSamples);
+  }
+
+  // 3. Mix
+  if (needsDry) {
+    const float *ramp =
+        mix.fill(mixRamp.data(), numSamples) ? mixRamp.data() : nullptr;
+    for (int ch = 0; ch < channels; ++ch)
+      BlockRamp::crossfade(buffer.getWritePointer(ch),
+                           dryBuffer.getReadPointer(ch), ramp, mix.getEnd(),
+                           numSamples);
+  }
+}
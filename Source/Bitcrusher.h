@@ -0,0 +1,73 @@
+#pragma once
+#include "BlockRamp.h"
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/**
+    Bit depth and sample-rate reduction for the Distortion slot (replaces the
+    fixed 4x / 8-bit crusher).
+
+    Both settings are continuous. The rate reduction is a fractional
+    sample-and-hold: a phase accumulator at the target rate triggers each new
+    hold, and the held value is interpolated back to the exact crossing point,
+    so 7.3 kHz really holds at 7.3 kHz instead of the nearest integer factor.
+    An optional low-pass ahead of the hold removes the content that would
+    fold back (the classic crusher keeps it for the grit).
+
+    The hold and the filter are one scalar loop; quantisation, TPDF dither
+    and the mix run over the whole block with vector ops. Rounding uses the
+    float magic-number trick instead of std::round, so that loop vectorises
+    too. Settings take one smoothing step per block; the mix is ramped across
+    it, and a fully dry crusher is skipped.
+*/
+class Bitcrusher {
+public:
+  struct Parameters {
+    float bits = 8.0f;       // 1 - 16, continuous
+    float rateHz = 11025.0f; // Held sample rate
+    float mix = 0.0f;
+    float dither = 0.0f;    // 0 - 1, 1 = TPDF at +/-1 LSB
+    bool antiAlias = false; // Low-pass ahead of the hold
+  };
+
+  Bitcrusher() = default;
+
+  void prepare(const juce::dsp::ProcessSpec &spec);
+  void reset();
+
+  void setParameters(const Parameters &newParams) { params = newParams; }
+  void process(juce::AudioBuffer<float> &buffer);
+
+private:
+  static constexpr double smoothingSeconds = 0.05;
+
+  // Rounds data to multiples of step after adding noise * ditherGain
+  static void quantise(float *data, const float *noise, float ditherGain,
+                       float step, int numSamples);
+  void fillNoise(float *dest, int numSamples);
+  void updateTargets();
+
+  struct ChannelState {
+    float ic1eq = 0.0f, ic2eq = 0.0f; // Anti-alias SVF
+    float held = 0.0f, last = 0.0f;   // Sample-and-hold
+  };
+
+  Parameters params;
+  double sampleRate = 44100.0;
+  int numChannels = 2;
+
+  // Smoothed settings (bits and rate are held at the block's end value)
+  BlockRamp bits{8.0f}, rateHz{11025.0f}, mix;
+  bool idle = true;
+
+  // Hold phase, shared so both channels hold on the same samples
+  float phase = 0.0f;
+  std::array<ChannelState, 2> state;
+
+  juce::uint32 noiseSeed = 22222;
+  std::vector<float> noise, mixRamp;
+  juce::AudioBuffer<float> dryBuffer;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Bitcrusher)
+};
@@ -0,0 +1,40 @@
+#include "BlockRamp.h"
+
+void BlockRamp::next(int numSamples) {
+  start = current;
+  if (current == target)
+    return;
+
+  const float coeff =
+      1.0f - (float)std::exp(-(double)numSamples / timeConstantSamples);
+  current += (target - current) * coeff;
+
+  // Close enough: settle exactly, so the constant fast path kicks in
+  if (std::abs(target - current) <=
+      1.0e-6f * juce::jmax(1.0f, std::abs(target)))
+    current = target;
+}
+
+bool BlockRamp::fill(float *dest, int length, float scale,
+                     float offset) const {
+  if (!isSmoothing() || length <= 0)
+    return false;
+
+  const float first = offset + scale * start;
+  const float step = scale * (current - start) / (float)length;
+  for (int i = 0; i < length; ++i)
+    dest[i] = first + step * (float)(i + 1);
+  return true;
+}
+
+void BlockRamp::crossfade(float *wet, const float *dry, const float *ramp,
+                          float value, int numSamples) {
+  using FVO = juce::FloatVectorOperations;
+
+  FVO::subtract(wet, dry, numSamples);
+  if (ramp != nullptr)
+    FVO::multiply(wet, ramp, numSamples);
+  else
+    FVO::multiply(wet, value, numSamples);
+  FVO::add(wet, dry, numSamples);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Block-rate parameter smoothing for the effects.
+
+    A ramp takes one one-pole step towards its target per block and moves
+    linearly across the block in between (sample i of n sits at
+    start + (end - start) * (i + 1) / n). Instead of a smoother asked for
+    its next value inside every DSP loop, fill() writes the whole block's
+    ramp into a contiguous buffer once, so kernels take it as an array input
+    and stay vector operations. While the value is not moving fill() writes
+    nothing and returns false, and the kernel takes its scalar fast path
+    with getEnd().
+*/
+class BlockRamp {
+public:
+  BlockRamp() = default;
+  explicit BlockRamp(float initialValue)
+      : target(initialValue), start(initialValue), current(initialValue) {}
+
+  void prepare(double sampleRate, double smoothingSeconds) {
+    timeConstantSamples = juce::jmax(1.0, smoothingSeconds * sampleRate);
+  }
+
+  void setTarget(float newTarget) { target = newTarget; }
+  float getTarget() const { return target; }
+
+  // Lands on the target with no glide (reset, first block after idling)
+  void snapToTarget() { start = current = target; }
+
+  // This block's smoothing step; call once per block before reading
+  void next(int numSamples);
+
+  float getStart() const { return start; }
+  float getEnd() const { return current; }
+  bool isSmoothing() const { return start != current; }
+
+  // Writes offset + scale * ramp for length samples (length may differ from
+  // the block length, e.g. at an oversampled rate). Returns false and
+  // writes nothing while the value is constant.
+  bool fill(float *dest, int length, float scale = 1.0f,
+            float offset = 0.0f) const;
+
+  // wet = dry + (wet - dry) * mix, with mix a ramp (array) or, when ramp is
+  // null, the constant value
+  static void crossfade(float *wet, const float *dry, const float *ramp,
+                        float value, int numSamples);
+
+private:
+  double timeConstantSamples = 0.05 * 44100.0;
+  float target = 0.0f, start = 0.0f, current = 0.0f;
+};
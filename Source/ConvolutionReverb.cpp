@@ -0,0 +1,590 @@
+#include "ConvolutionReverb.h"
+#include "SampleRateConverter.h"
+
+namespace {
+constexpr int headSize = 64; // Direct FIR taps, and the smallest partition
+
+//==============================================================================
+// Uniformly partitioned overlap-save convolver for one channel. Spectra are
+// kept split into real / imaginary arrays so the multiply-accumulate over
+// partitions is a plain loop the compiler vectorises.
+class PartitionedConvolver {
+public:
+  void prepare(const float *ir, int irLength, int newBlockSize) {
+    blockSize = newBlockSize;
+    numBins = blockSize + 1;
+    numPartitions = juce::jmax(1, (irLength + blockSize - 1) / blockSize);
+    fft = std::make_unique<juce::dsp::FFT>(
+        juce::roundToInt(std::log2(2.0 * blockSize)));
+
+    const auto spectrumSize = (size_t)(numPartitions * numBins);
+    irReal.assign(spectrumSize, 0.0f);
+    irImag.assign(spectrumSize, 0.0f);
+    fdlReal.assign(spectrumSize, 0.0f);
+    fdlImag.assign(spectrumSize, 0.0f);
+    accReal.assign((size_t)numBins, 0.0f);
+    accImag.assign((size_t)numBins, 0.0f);
+    window.assign((size_t)(2 * blockSize), 0.0f);
+    fftBuffer.assign((size_t)(4 * blockSize), 0.0f);
+
+    // Each partition: blockSize taps zero-padded to the FFT size
+    for (int p = 0; p < numPartitions; ++p) {
+      std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+      const int start = p * blockSize;
+      const int count = juce::jmin(blockSize, irLength - start);
+      if (count > 0)
+        std::copy(ir + start, ir + start + count, fftBuffer.begin());
+
+      fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+      splitSpectrum(irReal.data() + p * numBins, irImag.data() + p * numBins);
+    }
+
+    reset();
+  }
+
+  void reset() {
+    std::fill(fdlReal.begin(), fdlReal.end(), 0.0f);
+    std::fill(fdlImag.begin(), fdlImag.end(), 0.0f);
+    std::fill(window.begin(), window.end(), 0.0f);
+    fdlPos = 0;
+  }
+
+  // blockSize samples in, the convolution over that block out
+  void process(const float *input, float *output) {
+    // 1. Overlap-save: transform the last two blocks of input
+    std::copy(window.begin() + blockSize, window.end(), window.begin());
+    std::copy(input, input + blockSize, window.begin() + blockSize);
+    std::copy(window.begin(), window.end(), fftBuffer.begin());
+    std::fill(fftBuffer.begin() + 2 * blockSize, fftBuffer.end(), 0.0f);
+    fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    // 2. Newest spectrum into the frequency-domain delay line
+    fdlPos = fdlPos == 0 ? numPartitions - 1 : fdlPos - 1;
+    splitSpectrum(fdlReal.data() + fdlPos * numBins,
+                  fdlImag.data() + fdlPos * numBins);
+
+    // 3. Partition p pairs with the spectrum p blocks old
+    std::fill(accReal.begin(), accReal.end(), 0.0f);
+    std::fill(accImag.begin(), accImag.end(), 0.0f);
+    float *ar = accReal.data();
+    float *ai = accImag.data();
+
+    for (int p = 0; p < numPartitions; ++p) {
+      const int slot = (fdlPos + p) % numPartitions;
+      const float *xr = fdlReal.data() + slot * numBins;
+      const float *xi = fdlImag.data() + slot * numBins;
+      const float *hr = irReal.data() + p * numBins;
+      const float *hi = irImag.data() + p * numBins;
+
+      for (int b = 0; b < numBins; ++b) {
+        ar[b] += xr[b] * hr[b] - xi[b] * hi[b];
+        ai[b] += xr[b] * hi[b] + xi[b] * hr[b];
+      }
+    }
+
+    // 4. Back to the time domain; only the last blockSize samples are valid
+    for (int b = 0; b < numBins; ++b) {
+      fftBuffer[(size_t)(2 * b)] = ar[b];
+      fftBuffer[(size_t)(2 * b + 1)] = ai[b];
+    }
+    fft->performRealOnlyInverseTransform(fftBuffer.data());
+    std::copy(fftBuffer.begin() + blockSize, fftBuffer.begin() + 2 * blockSize,
+              output);
+  }
+
+private:
+  void splitSpectrum(float *re, float *im) const {
+    for (int b = 0; b < numBins; ++b) {
+      re[b] = fftBuffer[(size_t)(2 * b)];
+      im[b] = fftBuffer[(size_t)(2 * b + 1)];
+    }
+  }
+
+  std::unique_ptr<juce::dsp::FFT> fft;
+  int blockSize = 0, numBins = 0, numPartitions = 0;
+  std::vector<float> irReal, irImag;   // numPartitions spectra
+  std::vector<float> fdlReal, fdlImag; // Same layout, ring of input spectra
+  int fdlPos = 0;
+  std::vector<float> accReal, accImag;
+  std::vector<float> window;    // Last two blocks of input
+  std::vector<float> fftBuffer; // 2 * FFT size, as juce::dsp::FFT wants
+};
+
+//==============================================================================
+// One partition size covering one segment of the IR. Inline stages convolve
+// on the audio thread at each block boundary and play the result over the
+// next block (segment offset = one block). Threaded stages hand the block to
+// their own worker and play its result a block later (offset = two blocks).
+class ConvolutionStage : private juce::Thread {
+public:
+  ConvolutionStage(const juce::AudioBuffer<float> &ir, int segmentStart,
+                   int segmentLength, int newBlockSize, bool runOnWorker)
+      : juce::Thread("Convolution Tail"), blockSize(newBlockSize),
+        threaded(runOnWorker) {
+    for (int ch = 0; ch < 2; ++ch) {
+      const int source = juce::jmin(ch, ir.getNumChannels() - 1);
+      convolvers[(size_t)ch].prepare(ir.getReadPointer(source, segmentStart),
+                                     segmentLength, blockSize);
+    }
+
+    input.setSize(2, blockSize);
+    playback.setSize(2, blockSize);
+    if (threaded) {
+      workerInput.setSize(2, blockSize);
+      workerOutput.setSize(2, blockSize);
+    }
+    clearBuffers();
+    maxSpinTicks = juce::jmax(
+        (juce::int64)1,
+        (juce::int64)((double)juce::Time::getHighResolutionTicksPerSecond() *
+                      maxSpinSeconds));
+
+    if (threaded && !startRealtimeThread(juce::Thread::RealtimeOptions{}))
+      startThread(juce::Thread::Priority::highest);
+  }
+
+  ~ConvolutionStage() override {
+    signalThreadShouldExit();
+    workReady.signal();
+    stopThread(2000);
+  }
+
+  // Audio thread. Never waits: convolvers still busy on the worker are
+  // cleared at the first block boundary after it finishes.
+  void reset() {
+    input.clear();
+    playback.clear();
+    fill = 0;
+
+    if (!threaded || isWorkerDone())
+      clearConvolvers();
+    else
+      clearPending = true;
+  }
+
+  // Adds this stage's output for the next numSamples and queues the input.
+  // numSamples never crosses one of this stage's block boundaries.
+  void process(const float *const *in, float *const *out, int numChannels,
+               int numSamples, bool offline) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+      juce::FloatVectorOperations::copy(input.getWritePointer(ch, fill),
+                                        in[ch], numSamples);
+      juce::FloatVectorOperations::add(
+          out[ch], playback.getReadPointer(ch, fill), numSamples);
+    }
+
+    fill += numSamples;
+    if (fill == blockSize) {
+      fill = 0;
+      finishBlock(numChannels, offline);
+    }
+  }
+
+private:
+  void finishBlock(int numChannels, bool offline) {
+    if (!threaded) {
+      for (int ch = 0; ch < numChannels; ++ch)
+        convolvers[(size_t)ch].process(input.getReadPointer(ch),
+                                       playback.getWritePointer(ch));
+      return;
+    }
+
+    // The previous block had a whole block period to finish, so the worker
+    // is only late when the machine is overloaded or the host renders faster
+    // than real time. Then this stage is silent for a block and the block's
+    // input is dropped; the late result plays from the next boundary.
+    // Offline, nobody is listening in real time, so it is waited for.
+    if (offline)
+      while (!isWorkerDone())
+        juce::Thread::yield();
+    if (!isWorkerDone()) {
+      playback.clear();
+      return;
+    }
+    if (clearPending) {
+      clearConvolvers();
+      clearPending = false;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      playback.copyFrom(ch, 0, workerOutput, ch, 0, blockSize);
+      workerInput.copyFrom(ch, 0, input, ch, 0, blockSize);
+    }
+    workerChannels = numChannels;
+    submitted.store(submitted.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    workReady.signal();
+  }
+
+  // Completion check with a bounded spin (no sleeping, no locks)
+  bool isWorkerDone() const {
+    const int target = submitted.load(std::memory_order_relaxed);
+    if (completed.load(std::memory_order_acquire) == target)
+      return true;
+
+    const auto deadline = juce::Time::getHighResolutionTicks() + maxSpinTicks;
+    while (juce::Time::getHighResolutionTicks() < deadline)
+      if (completed.load(std::memory_order_acquire) == target)
+        return true;
+    return false;
+  }
+
+  void run() override {
+    while (!threadShouldExit()) {
+      workReady.wait(100.0);
+
+      const int target = submitted.load(std::memory_order_acquire);
+      if (target == completed.load(std::memory_order_relaxed))
+        continue;
+
+      for (int ch = 0; ch < workerChannels; ++ch)
+        convolvers[(size_t)ch].process(workerInput.getReadPointer(ch),
+                                       workerOutput.getWritePointer(ch));
+
+      completed.store(target, std::memory_order_release);
+    }
+  }
+
+  void clearBuffers() {
+    input.clear();
+    playback.clear();
+    workerInput.clear();
+    workerOutput.clear();
+  }
+
+  // Only while the worker is idle
+  void clearConvolvers() {
+    workerInput.clear();
+    workerOutput.clear();
+    for (auto &convolver : convolvers)
+      convolver.reset();
+  }
+
+  // Longest the audio thread spins on a worker about to finish
+  static constexpr double maxSpinSeconds = 5.0e-6;
+  juce::int64 maxSpinTicks = 0;
+
+  const int blockSize;
+  const bool threaded;
+  std::array<PartitionedConvolver, 2> convolvers;
+
+  // Audio thread
+  juce::AudioBuffer<float> input, playback;
+  int fill = 0;
+  bool clearPending = false; // reset() while the worker was busy
+
+  // Handoff: the audio thread bumps submitted, the worker catches up
+  juce::AudioBuffer<float> workerInput, workerOutput;
+  int workerChannels = 2;
+  std::atomic<int> submitted{0}, completed{0};
+  juce::WaitableEvent workReady; // Wakes the worker; never waited on here
+};
+} // namespace
+
+//==============================================================================
+class ConvolutionReverb::Engine {
+public:
+  // Empty engine: clears the IR when swapped in
+  explicit Engine(double rate) : sampleRate(rate) {}
+
+  Engine(const juce::AudioBuffer<float> &ir, int length, double rate)
+      : sampleRate(rate) {
+    // Direct head: taps 0 - 63
+    for (int ch = 0; ch < 2; ++ch) {
+      const int source = juce::jmin(ch, ir.getNumChannels() - 1);
+      auto &taps = headTaps[(size_t)ch];
+      taps.assign((size_t)headSize, 0.0f);
+      std::copy(ir.getReadPointer(source),
+                ir.getReadPointer(source) + juce::jmin(length, headSize),
+                taps.begin());
+      headHistory[(size_t)ch].assign((size_t)(2 * headSize - 1), 0.0f);
+    }
+
+    // Partition sizes, each starting where its block timing allows
+    struct Layout {
+      int blockSize, start, end;
+      bool threaded;
+    };
+    const Layout layouts[] = {{headSize, headSize, 2048, false},
+                              {1024, 2048, 16384, true},
+                              {8192, 16384, length, true}};
+
+    for (const auto &layout : layouts) {
+      const int end = juce::jmin(layout.end, length);
+      if (end > layout.start)
+        stages.push_back(std::make_unique<ConvolutionStage>(
+            ir, layout.start, end - layout.start, layout.blockSize,
+            layout.threaded));
+    }
+
+    hasResponse = length > 0;
+    lengthSeconds = (float)(length / rate);
+  }
+
+  double getSampleRate() const { return sampleRate; }
+  float getLengthSeconds() const { return lengthSeconds; }
+  bool isEmpty() const { return !hasResponse; }
+
+  void reset() {
+    for (auto &history : headHistory)
+      std::fill(history.begin(), history.end(), 0.0f);
+    for (auto &stage : stages)
+      stage->reset();
+    headFill = 0;
+  }
+
+  // Wet signal only: out is overwritten
+  void process(const float *const *in, float *const *out, int numChannels,
+               int numSamples, bool offline) {
+    const float *chunkIn[2] = {};
+    float *chunkOut[2] = {};
+    int pos = 0;
+
+    while (pos < numSamples) {
+      // Chunks end on 64-sample boundaries, which are boundaries of every
+      // stage since the partition sizes are all multiples of 64
+      const int n = juce::jmin(numSamples - pos, headSize - headFill);
+
+      for (int ch = 0; ch < numChannels; ++ch) {
+        chunkIn[ch] = in[ch] + pos;
+        chunkOut[ch] = out[ch] + pos;
+        processHead(ch, chunkIn[ch], chunkOut[ch], n);
+      }
+
+      for (auto &stage : stages)
+        stage->process(chunkIn, chunkOut, numChannels, n, offline);
+
+      headFill = (headFill + n) % headSize;
+      pos += n;
+    }
+  }
+
+private:
+  // Direct convolution, one vector op per tap over the chunk. history holds
+  // the previous headSize - 1 inputs followed by the chunk.
+  void processHead(int ch, const float *in, float *out, int n) {
+    auto &history = headHistory[(size_t)ch];
+    const auto &taps = headTaps[(size_t)ch];
+    float *newest = history.data() + headSize - 1;
+    juce::FloatVectorOperations::copy(newest, in, n);
+
+    juce::FloatVectorOperations::multiply(out, newest, taps[0], n);
+    for (int k = 1; k < headSize; ++k)
+      juce::FloatVectorOperations::addWithMultiply(out, newest - k,
+                                                   taps[(size_t)k], n);
+
+    std::copy(history.begin() + n, history.begin() + n + headSize - 1,
+              history.begin());
+  }
+
+  const double sampleRate;
+  bool hasResponse = false;
+  float lengthSeconds = 0.0f;
+
+  std::array<std::vector<float>, 2> headTaps, headHistory;
+  int headFill = 0;
+
+  std::vector<std::unique_ptr<ConvolutionStage>> stages;
+};
+
+//==============================================================================
+ConvolutionReverb::ConvolutionReverb()
+    : loader(juce::ThreadPoolOptions{}
+                 .withThreadName("IR Loader")
+                 .withNumberOfThreads(1)) {
+  formats.registerBasicFormats();
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+  loader.removeAllJobs(true, 10000);
+  delete pendingEngine.exchange(nullptr);
+  delete retiredEngine.exchange(nullptr);
+}
+
+void ConvolutionReverb::prepare(double newSampleRate, int maximumBlockSize) {
+  const bool rateChanged = newSampleRate != sampleRate;
+  sampleRate = newSampleRate;
+  wetBuffer.setSize(2, juce::jmax(1, maximumBlockSize));
+
+  // Audio is stopped here, so engines can be freed directly
+  delete retiredEngine.exchange(nullptr);
+  if (rateChanged) {
+    delete pendingEngine.exchange(nullptr);
+    engine.reset();
+    responseSeconds = 0.0f;
+
+    const auto file = getImpulseResponseFile();
+    if (file.existsAsFile())
+      startLoad(file, sampleRate); // Re-resample for the new rate
+  }
+
+  reset();
+}
+
+void ConvolutionReverb::reset() {
+  if (engine != nullptr)
+    engine->reset();
+  idle = true;
+}
+
+//==============================================================================
+void ConvolutionReverb::loadImpulseResponse(const juce::File &file) {
+  {
+    const juce::ScopedLock sl(fileLock);
+    irFile = file;
+  }
+  startLoad(file, sampleRate);
+}
+
+void ConvolutionReverb::clearImpulseResponse() {
+  {
+    const juce::ScopedLock sl(fileLock);
+    irFile = juce::File();
+  }
+  startLoad(juce::File(), sampleRate);
+}
+
+juce::File ConvolutionReverb::getImpulseResponseFile() const {
+  const juce::ScopedLock sl(fileLock);
+  return irFile;
+}
+
+void ConvolutionReverb::startLoad(const juce::File &file, double rate) {
+  ++pendingLoads;
+  loader.addJob([this, file, rate] {
+    auto newEngine = file == juce::File() ? std::make_unique<Engine>(rate)
+                                          : createEngine(file, rate);
+
+    // Whatever the audio thread swapped out last time is free to go
+    delete retiredEngine.exchange(nullptr);
+    if (newEngine != nullptr)
+      delete pendingEngine.exchange(newEngine.release());
+
+    --pendingLoads;
+  });
+}
+
+std::unique_ptr<ConvolutionReverb::Engine>
+ConvolutionReverb::createEngine(const juce::File &file, double rate) {
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formats.createReaderFor(file));
+  if (reader == nullptr || reader->sampleRate <= 0.0)
+    return nullptr;
+
+  const int sourceLength = (int)juce::jmin(
+      reader->lengthInSamples, (juce::int64)(maxSeconds * reader->sampleRate));
+  if (sourceLength <= 0)
+    return nullptr;
+
+  // Stereo IRs run L -> L and R -> R; mono ones feed both sides
+  juce::AudioBuffer<float> source(
+      juce::jlimit(1, 2, (int)reader->numChannels), sourceLength);
+  reader->read(&source, 0, sourceLength, 0, true, true);
+
+  const juce::AudioBuffer<float> *ir = &source;
+  int length = sourceLength;
+
+  std::unique_ptr<ConvertedSample> converted;
+  if (std::abs(reader->sampleRate - rate) > 0.5) {
+    converted = ConvertedSample::convert(source, sourceLength,
+                                         reader->sampleRate, rate);
+    if (converted == nullptr)
+      return nullptr;
+    ir = &converted->data;
+    length = converted->length;
+  }
+
+  // Trim the silent end: no partitions spent on it
+  while (length > 1 && ir->getMagnitude(length - 1, 1) < 1.0e-5f)
+    --length;
+
+  // Equal-energy normalisation (-6 dB), so quiet and hot files sit at the
+  // same wet level
+  double energy = 0.0;
+  for (int ch = 0; ch < ir->getNumChannels(); ++ch)
+    for (int i = 0; i < length; ++i)
+      energy += juce::square((double)ir->getSample(ch, i));
+  energy /= (double)ir->getNumChannels();
+  if (energy < 1.0e-12)
+    return nullptr;
+
+  juce::AudioBuffer<float> normalised(ir->getNumChannels(), length);
+  const float gain = (float)(0.5 / std::sqrt(energy));
+  for (int ch = 0; ch < ir->getNumChannels(); ++ch)
+    normalised.copyFrom(ch, 0, *ir, ch, 0, length);
+  normalised.applyGain(gain);
+
+  return std::make_unique<Engine>(normalised, length, rate);
+}
+
+void ConvolutionReverb::swapInPendingEngine() {
+  // Only while the last retired engine has been collected, so nothing is
+  // ever freed here
+  if (retiredEngine.load(std::memory_order_acquire) != nullptr)
+    return;
+
+  auto *next = pendingEngine.exchange(nullptr, std::memory_order_acq_rel);
+  if (next == nullptr)
+    return;
+
+  if (next->getSampleRate() != sampleRate) {
+    retiredEngine.store(next, std::memory_order_release); // Stale rate
+    return;
+  }
+
+  // The new engine starts from silence; the old tail is cut
+  retiredEngine.store(engine.release(), std::memory_order_release);
+  engine.reset(next);
+  responseSeconds = engine->getLengthSeconds();
+}
+
+//==============================================================================
+void ConvolutionReverb::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = juce::jmin(2, buffer.getNumChannels());
+  if (numSamples == 0 || numChannels == 0)
+    return;
+
+  swapInPendingEngine();
+
+  // Mix: one smoothing step per block, ramped across it
+  const float coeff = 1.0f - (float)std::exp(-(double)numSamples /
+                                             (smoothingSeconds * sampleRate));
+  const float mixStart = mix;
+  mix += (params.mix - mix) * coeff;
+
+  if ((mixStart < 1.0e-4f && mix < 1.0e-4f) || engine == nullptr ||
+      engine->isEmpty()) {
+    idle = true;
+    return;
+  }
+  if (idle) {
+    engine->reset(); // Start from silence, not a stale tail
+    idle = false;
+  }
+
+  const float mixStep = (mix - mixStart) / (float)numSamples;
+  int pos = 0;
+
+  while (pos < numSamples) {
+    const int n = juce::jmin(numSamples - pos, wetBuffer.getNumSamples());
+
+    const float *in[2] = {};
+    float *wet[2] = {};
+    for (int ch = 0; ch < numChannels; ++ch) {
+      in[ch] = buffer.getReadPointer(ch, pos);
+      wet[ch] = wetBuffer.getWritePointer(ch);
+    }
+    engine->process(in, wet, numChannels, n, params.offline);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto *data = buffer.getWritePointer(ch, pos);
+      for (int i = 0; i < n; ++i) {
+        const float m = mixStart + mixStep * (float)(pos + i + 1);
+        data[i] = data[i] * (1.0f - m) + wet[ch][i] * m;
+      }
+    }
+
+    pos += n;
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+    Convolution reverb for user impulse responses, after the FDN reverb.
+
+    The IR is cut into non-uniform stages so a response several seconds long
+    costs the audio thread the same small amount every block:
+      - taps 0 - 63 run as a direct FIR, so the wet signal has no latency;
+      - taps 64 - 2047 run as a 64-sample partitioned FFT convolver on the
+        audio thread (a block's result is due one block later, exactly when
+        those taps start);
+      - taps 2048 - 16383 (1024-sample partitions) and the rest (8192-sample
+        partitions) each run on their own worker thread. Their taps start two
+        blocks in, so every block has a whole block period to finish while
+        the audio thread plays the previous result. The audio thread never
+        waits for them: a late stage is silent for one of its blocks.
+    A uniform 64-sample convolver does the same maths but spends all of it on
+    the audio thread (hundreds of partitions per block); one big partition
+    instead spikes once every few blocks.
+
+    Files are read, resampled to the host rate and partitioned on a loader
+    thread. The finished engine is handed over with an atomic swap, and the
+    old one is freed by the loader, never on the audio thread.
+*/
+class ConvolutionReverb {
+public:
+  struct Parameters {
+    float mix = 0.0f;
+    // Host renders faster than real time: late tail stages are waited for
+    // instead of dropping a block (never in real time)
+    bool offline = false;
+  };
+
+  ConvolutionReverb();
+  ~ConvolutionReverb();
+
+  void prepare(double newSampleRate, int maximumBlockSize);
+  void reset();
+
+  void setParameters(const Parameters &newParams) { params = newParams; }
+  void process(juce::AudioBuffer<float> &buffer);
+
+  // Message thread. The wet signal keeps the previous IR (or stays silent)
+  // until the new one is ready.
+  void loadImpulseResponse(const juce::File &file);
+  void clearImpulseResponse();
+  juce::File getImpulseResponseFile() const;
+  bool isLoading() const { return pendingLoads.load() > 0; }
+
+  // Length of the IR playing now, 0 while dry or empty
+  float getTailSeconds() const {
+    return params.mix < 1.0e-4f ? 0.0f : responseSeconds.load();
+  }
+
+  // Partitioned IR and convolution state for one file at one rate (.cpp)
+  class Engine;
+
+private:
+  static constexpr double maxSeconds = 12.0;
+  static constexpr double smoothingSeconds = 0.05;
+
+  void startLoad(const juce::File &file, double rate);
+  std::unique_ptr<Engine> createEngine(const juce::File &file, double rate);
+  void swapInPendingEngine();
+
+  Parameters params;
+  double sampleRate = 44100.0;
+
+  // Audio thread side
+  std::unique_ptr<Engine> engine;
+  juce::AudioBuffer<float> wetBuffer;
+  float mix = 0.0f;
+  bool idle = true;
+  std::atomic<float> responseSeconds{0.0f};
+
+  // Handover: the loader publishes into pendingEngine; the audio thread
+  // swaps it in and parks the old engine in retiredEngine for the loader to
+  // delete next time round.
+  std::atomic<Engine *> pendingEngine{nullptr};
+  std::atomic<Engine *> retiredEngine{nullptr};
+
+  // Loader
+  juce::ThreadPool loader;
+  juce::AudioFormatManager formats;
+  juce::CriticalSection fileLock;
+  juce::File irFile;
+  std::atomic<int> pendingLoads{0};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionReverb)
+};
@@ -0,0 +1,148 @@
+#include "Distortion.h"
+
+void Distortion::prepare(const juce::dsp::ProcessSpec &spec) {
+  using OS = juce::dsp::Oversampling<float>;
+
+  sampleRate = spec.sampleRate;
+  numChannels = juce::jmax(1, (int)spec.numChannels);
+
+  // Linear phase with a whole-sample latency, so a plain delay matches it
+  int maxLatency = 0;
+  for (int order = 1; order <= maxOrder; ++order) {
+    auto &os = oversamplers[(size_t)order - 1];
+    os = std::make_unique<OS>((size_t)numChannels, (size_t)order,
+                              OS::filterHalfBandFIREquiripple, true, true);
+    os->initProcessing(spec.maximumBlockSize);
+
+    const int latency = juce::roundToInt(os->getLatencyInSamples());
+    latencyForOrder[(size_t)order] = latency;
+    maxLatency = juce::jmax(maxLatency, latency);
+  }
+
+  drive.prepare(sampleRate, smoothingSeconds);
+  mix.prepare(sampleRate, smoothingSeconds);
+  gainRamp.resize((size_t)spec.maximumBlockSize << maxOrder);
+  mixRamp.resize((size_t)spec.maximumBlockSize);
+  dryBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+  dryHistory.setSize(numChannels, maxLatency + (int)spec.maximumBlockSize);
+  reset();
+}
+
+void Distortion::reset() {
+  for (auto &os : oversamplers)
+    if (os != nullptr)
+      os->reset();
+  dryHistory.clear();
+
+  // Land on the targets rather than gliding in from stale values
+  drive.snapToTarget();
+  mix.snapToTarget();
+}
+
+void Distortion::setOversampling(int index) {
+  const int order = juce::jlimit(0, maxOrder, index);
+  if (order == oversamplingOrder)
+    return;
+
+  oversamplingOrder = order;
+  if (order > 0 && oversamplers[(size_t)order - 1] != nullptr)
+    oversamplers[(size_t)order - 1]->reset(); // No stale filter history
+
+  // The latency changes with the factor: restart the dry delay (a click,
+  // like any latency change)
+  dryHistory.clear();
+}
+
+void Distortion::shape(float *data, const float *gain, int numSamples) {
+  juce::FloatVectorOperations::multiply(data, gain, numSamples);
+  shape(data, 1.0f, numSamples);
+}
+
+void Distortion::shape(float *data, float gain, int numSamples) {
+  if (gain != 1.0f)
+    juce::FloatVectorOperations::multiply(data, gain, numSamples);
+  juce::FloatVectorOperations::clip(data, data, -3.0f, 3.0f, numSamples);
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float x = data[i];
+    const float x2 = x * x;
+    data[i] = x * (27.0f + x2) / (27.0f + 9.0f * x2);
+  }
+}
+
+void Distortion::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+  if (numSamples == 0 || channels == 0 || gainRamp.empty())
+    return;
+
+  // One smoothing step per block, ramped linearly across it
+  drive.next(numSamples);
+  mix.next(numSamples);
+
+  if (mix.getStart() < 1.0e-4f && mix.getEnd() < 1.0e-4f) {
+    // Fully dry: clean bypass, still delayed so the reported latency holds
+    for (int ch = 0; ch < channels; ++ch)
+      delay(ch, buffer.getWritePointer(ch), numSamples);
+    bypassed = true;
+    return;
+  }
+
+  auto *os = oversamplingOrder > 0
+                 ? oversamplers[(size_t)oversamplingOrder - 1].get()
+                 : nullptr;
+  if (bypassed) {
+    if (os != nullptr)
+      os->reset(); // Its filters last saw audio before the bypass
+    bypassed = false;
+  }
+
+  // The dry line always runs, so it is current when the mix moves
+  const bool needsDry = mix.getStart() < 1.0f || mix.getEnd() < 1.0f;
+  for (int ch = 0; ch < channels; ++ch) {
+    dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    delay(ch, dryBuffer.getWritePointer(ch), numSamples);
+  }
+
+  juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(),
+                                     (size_t)channels, (size_t)numSamples);
+
+  auto upsampled = os != nullptr ? os->processSamplesUp(block) : block;
+  const int upSamples = (int)upsampled.getNumSamples();
+
+  // Drive 0 - 1 maps to 1x - 50x input gain, ramped at the upsampled rate
+  if (drive.fill(gainRamp.data(), upSamples, 49.0f, 1.0f)) {
+    for (int ch = 0; ch < channels; ++ch)
+      shape(upsampled.getChannelPointer((size_t)ch), gainRamp.data(),
+            upSamples);
+  } else {
+    const float gain = 1.0f + drive.getEnd() * 49.0f;
+    for (int ch = 0; ch < channels; ++ch)
+      shape(upsampled.getChannelPointer((size_t)ch), gain, upSamples);
+  }
+
+  if (os != nullptr)
+    os->processSamplesDown(block);
+
+  if (needsDry) {
+    const float *ramp =
+        mix.fill(mixRamp.data(), numSamples) ? mixRamp.data() : nullptr;
+    for (int ch = 0; ch < channels; ++ch)
+      BlockRamp::crossfade(buffer.getWritePointer(ch),
+                           dryBuffer.getReadPointer(ch), ramp, mix.getEnd(),
+                           numSamples);
+  }
+}
+
+void Distortion::delay(int channel, float *data, int numSamples) {
+  const int latency = getLatencySamples();
+  if (latency == 0)
+    return;
+
+  // history = [last latency samples | this block]; the first numSamples of
+  // it are the delayed block, the last latency samples carry over
+  auto *line = dryHistory.getWritePointer(channel);
+  juce::FloatVectorOperations::copy(line + latency, data, numSamples);
+  juce::FloatVectorOperations::copy(data, line, numSamples);
+  std::memmove(line, line + numSamples, sizeof(float) * (size_t)latency);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "BlockRamp.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+    Oversampled tanh-style distortion for the effects chain.
+
+    The shaper is a clipped rational approximation of tanh,
+        y = x (27 + x^2) / (27 + 9 x^2),   x clamped to +/-3
+    which meets +/-1 exactly at the clamp. It has no branches, so the kernel
+    is a couple of FloatVectorOperations plus one loop the compiler
+    vectorises, instead of a std::tanh call per sample.
+
+    Runs at 1x / 2x / 4x / 8x through JUCE's linear-phase FIR half-band
+    oversamplers so heavy drive (Hunt, Crush macro) does not fold back as
+    aliasing. Linear phase is a fixed delay (getLatencySamples, reported by
+    the processor): the dry path goes through the same delay, so any dry /
+    wet mix lines up instead of comb filtering. Drive and mix are
+    BlockRamps: array inputs to the kernel while they move, a single scalar
+    once they settle. A fully dry stage only runs the delay.
+*/
+class Distortion {
+public:
+  Distortion() = default;
+
+  void prepare(const juce::dsp::ProcessSpec &spec);
+  void reset();
+
+  // Drive 0.0 - 1.0 (1x - 50x input gain), mix 0.0 - 1.0
+  void setDrive(float newDrive) {
+    drive.setTarget(juce::jlimit(0.0f, 1.0f, newDrive));
+  }
+  void setMix(float newMix) { mix.setTarget(juce::jlimit(0.0f, 1.0f, newMix)); }
+  // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+  void setOversampling(int index);
+  int getOversamplingFactor() const { return 1 << oversamplingOrder; }
+
+  // Delay the oversampling filters add, in samples: at the current setting,
+  // or at a setOversampling index (any thread, after prepare)
+  int getLatencySamples() const { return getLatencySamples(oversamplingOrder); }
+  int getLatencySamples(int index) const {
+    return latencyForOrder[(size_t)juce::jlimit(0, maxOrder, index)].load();
+  }
+
+  void process(juce::AudioBuffer<float> &buffer);
+
+  // The shaper on its own: data[i] = shape(data[i] * gain[i]), or with one
+  // gain for the whole block
+  static void shape(float *data, const float *gain, int numSamples);
+  static void shape(float *data, float gain, int numSamples);
+
+private:
+  static constexpr int maxOrder = 3; // 8x
+  static constexpr double smoothingSeconds = 0.05;
+
+  std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOrder>
+      oversamplers; // 2x, 4x, 8x
+  std::array<std::atomic<int>, maxOrder + 1> latencyForOrder{};
+  int oversamplingOrder = 1;
+  bool bypassed = true; // Fully dry last block: oversampler history is stale
+
+  double sampleRate = 44100.0;
+  int numChannels = 2;
+
+  BlockRamp drive, mix;
+
+  std::vector<float> gainRamp;        // Upsampled length
+  std::vector<float> mixRamp;
+  juce::AudioBuffer<float> dryBuffer; // For the dry/wet mix
+
+  // Dry delay matching the oversamplers: per channel, the last latency
+  // samples followed by the block being processed
+  juce::AudioBuffer<float> dryHistory;
+  void delay(int channel, float *data, int numSamples);
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Distortion)
+};
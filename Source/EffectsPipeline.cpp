@@ -0,0 +1,165 @@
+#include "EffectsPipeline.h"
+
+EffectsPipeline::EffectsPipeline() : juce::Thread("Effects Pipeline") {}
+
+EffectsPipeline::~EffectsPipeline() { release(); }
+
+void EffectsPipeline::prepare(int newNumChannels, int maximumBlockSize,
+                              Callback callback) {
+  release();
+
+  processBlock = std::move(callback);
+  numChannels = juce::jmax(1, newNumChannels);
+  latency = juce::jmax(1, maximumBlockSize);
+
+  jobBuffer.setSize(numChannels, latency);
+  jobBuffer.clear();
+  jobSamples = 0;
+
+  // The FIFO starts full of silence (the reported latency) and stays full:
+  // every block reads as many samples as the block before it wrote
+  fifo.setSize(numChannels, latency);
+  fifo.clear();
+  readPos = writePos = 0;
+
+  lastBlock.setSize(numChannels, latency);
+  lastBlock.clear();
+  lastBlockSamples = 0;
+  maxSpinTicks = juce::jmax(
+      (juce::int64)1,
+      (juce::int64)((double)juce::Time::getHighResolutionTicksPerSecond() *
+                    maxSpinSeconds));
+
+  submitted = 0;
+  completed = 0;
+
+  if (!startRealtimeThread(juce::Thread::RealtimeOptions{}))
+    startThread(juce::Thread::Priority::highest);
+}
+
+void EffectsPipeline::release() {
+  if (isThreadRunning()) {
+    signalThreadShouldExit();
+    workReady.signal();
+    stopThread(2000);
+  }
+  latency = 0;
+}
+
+void EffectsPipeline::process(juce::AudioBuffer<float> &buffer,
+                              const Settings &settings, bool useWorker) {
+  if (latency == 0)
+    return;
+
+  const int numSamples = buffer.getNumSamples();
+
+  // Hosts stay within the prepared size; anything longer goes in pieces
+  for (int start = 0; start < numSamples; start += latency)
+    processChunk(buffer, settings, start,
+                 juce::jmin(latency, numSamples - start), useWorker);
+}
+
+void EffectsPipeline::processChunk(juce::AudioBuffer<float> &buffer,
+                                   const Settings &settings, int start,
+                                   int numSamples, bool useWorker) {
+  const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+
+  // The previous block had the whole time the voices took to render, so the
+  // worker is only late when the machine is overloaded. Then the last block
+  // plays again and this block's input is dropped; the late block comes out
+  // next time, so the delay does not grow.
+  if (!isWorkerDone()) {
+    repeatLastBlock(buffer, start, numSamples);
+    return;
+  }
+
+  // 1. Hand over the new block
+  for (int ch = 0; ch < channels; ++ch)
+    jobBuffer.copyFrom(ch, 0, buffer, ch, start, numSamples);
+  for (int ch = channels; ch < numChannels; ++ch)
+    jobBuffer.clear(ch, 0, numSamples);
+  jobSamples = numSamples;
+  jobSettings = settings;
+
+  // 2. Play out the oldest processed samples in its place
+  const int first = juce::jmin(numSamples, latency - readPos);
+  for (int ch = 0; ch < channels; ++ch) {
+    buffer.copyFrom(ch, start, fifo, ch, readPos, first);
+    if (first < numSamples)
+      buffer.copyFrom(ch, start + first, fifo, ch, 0, numSamples - first);
+  }
+  readPos = (readPos + numSamples) % latency;
+
+  for (int ch = 0; ch < channels; ++ch)
+    lastBlock.copyFrom(ch, 0, buffer, ch, start, numSamples);
+  lastBlockSamples = numSamples;
+
+  // 3. Process it: on the worker, or right here when rendering offline
+  if (useWorker) {
+    submitted.store(submitted.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    workReady.signal();
+  } else {
+    runJob();
+  }
+}
+
+void EffectsPipeline::runJob() {
+  juce::AudioBuffer<float> block(jobBuffer.getArrayOfWritePointers(),
+                                 numChannels, jobSamples);
+  if (processBlock)
+    processBlock(block, jobSettings);
+
+  const int first = juce::jmin(jobSamples, latency - writePos);
+  for (int ch = 0; ch < numChannels; ++ch) {
+    fifo.copyFrom(ch, writePos, block, ch, 0, first);
+    if (first < jobSamples)
+      fifo.copyFrom(ch, 0, block, ch, first, jobSamples - first);
+  }
+  writePos = (writePos + jobSamples) % latency;
+}
+
+bool EffectsPipeline::isWorkerDone() const {
+  const int target = submitted.load(std::memory_order_relaxed);
+  if (completed.load(std::memory_order_acquire) == target)
+    return true;
+
+  // Bounded spin for a worker that is just finishing: no sleeping, no locks
+  const auto deadline = juce::Time::getHighResolutionTicks() + maxSpinTicks;
+  while (juce::Time::getHighResolutionTicks() < deadline)
+    if (completed.load(std::memory_order_acquire) == target)
+      return true;
+  return false;
+}
+
+void EffectsPipeline::repeatLastBlock(juce::AudioBuffer<float> &buffer,
+                                      int start, int numSamples) {
+  const int channels = juce::jmin(numChannels, buffer.getNumChannels());
+  if (lastBlockSamples == 0) {
+    buffer.clear(start, numSamples);
+    return;
+  }
+
+  // Looped if this block is longer than the one played last
+  for (int done = 0; done < numSamples;) {
+    const int count = juce::jmin(lastBlockSamples, numSamples - done);
+    for (int ch = 0; ch < channels; ++ch)
+      buffer.copyFrom(ch, start + done, lastBlock, ch, 0, count);
+    done += count;
+  }
+}
+
+void EffectsPipeline::run() {
+  while (!threadShouldExit()) {
+    workReady.wait(100.0);
+
+    const int target = submitted.load(std::memory_order_acquire);
+    if (target == completed.load(std::memory_order_relaxed))
+      continue;
+
+    juce::ScopedNoDenormals noDenormals;
+    runJob();
+
+    completed.store(target, std::memory_order_release);
+  }
+}
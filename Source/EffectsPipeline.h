@@ -0,0 +1,94 @@
+#pragma once
+#include "EffectsProcessor.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/**
+    Runs the effects and master section one host block behind the synth, on
+    their own real-time thread.
+
+    Each processBlock the audio thread renders the voices for block N, picks
+    up the finished block N - 1 from the worker and hands it block N. The
+    worker then has a whole block period for the effects while the audio
+    thread renders block N + 1, so a heavy chain no longer sits on the same
+    critical path as the voices. The cost is a fixed delay of one prepared
+    block, which the processor reports to the host as latency.
+
+    Only the channels it was prepared with (the main bus) go through it; the
+    processor delays the dry aux buses by the same block so they stay
+    aligned with the main mix. The handoff is a pair of
+    counters: at most one block is in flight, and each side only touches the
+    shared buffers while the other is idle. The audio thread never waits on
+    the worker: it checks the counters, spinning for a few microseconds at
+    most. A worker that is still busy (an overloaded machine) costs a
+    glitch, not a stalled callback: the last block played is repeated and
+    this block's input is dropped, and the next block picks up the late one
+    so the delay stays one block. With useWorker false (offline renders) the
+    same block is processed inline; the delay stays put so nothing moves in
+    time.
+*/
+class EffectsPipeline : private juce::Thread {
+public:
+  // What the worker needs to process a block, captured on the audio thread
+  struct Settings {
+    EffectsProcessor::Parameters effects;
+    float gain = 0.5f;
+    float pan = 0.0f;
+    int mainChannels = 2; // Effects and master run on these; the rest is dry
+  };
+
+  using Callback =
+      std::function<void(juce::AudioBuffer<float> &, const Settings &)>;
+
+  EffectsPipeline();
+  ~EffectsPipeline() override;
+
+  // Message thread. Starts the worker; callback runs on it once per block.
+  void prepare(int numChannels, int maximumBlockSize, Callback callback);
+  void release();
+  bool isActive() const { return latency > 0; }
+  int getLatencySamples() const { return latency; }
+
+  // Audio thread. Queues the block in buffer and replaces it with the
+  // processed block from latency samples earlier.
+  void process(juce::AudioBuffer<float> &buffer, const Settings &settings,
+               bool useWorker);
+
+private:
+  void processChunk(juce::AudioBuffer<float> &buffer, const Settings &settings,
+                    int start, int numSamples, bool useWorker);
+  void runJob();
+  bool isWorkerDone() const;
+  void repeatLastBlock(juce::AudioBuffer<float> &buffer, int start,
+                       int numSamples);
+  void run() override;
+
+  // Longest the audio thread spins on a worker about to finish
+  static constexpr double maxSpinSeconds = 5.0e-6;
+  juce::int64 maxSpinTicks = 0;
+
+  Callback processBlock;
+  int latency = 0;
+  int numChannels = 0;
+
+  // Block handed to the worker, processed in place
+  juce::AudioBuffer<float> jobBuffer;
+  Settings jobSettings;
+  int jobSamples = 0;
+
+  // Processed audio waiting to be played: the worker writes, the audio
+  // thread reads (never at the same time)
+  juce::AudioBuffer<float> fifo;
+  int readPos = 0, writePos = 0;
+
+  // What the audio thread played last, repeated when the worker is late
+  juce::AudioBuffer<float> lastBlock;
+  int lastBlockSamples = 0;
+
+  std::atomic<int> submitted{0}, completed{0};
+  juce::WaitableEvent workReady; // Wakes the worker; never waited on here
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectsPipeline)
+};
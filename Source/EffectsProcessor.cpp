@@ -1,11 +1,10 @@
 #include "EffectsProcessor.h"
 
 EffectsProcessor::EffectsProcessor() {
-  // Initialize Waveshaper with tanh transfer function
-  distortion.functionToUse = [](float x) { return std::tanh(x); };
-
-  // Delay setup
-  delayLine.setMaximumDelayInSamples(44100 * 2);
+  // Standard chain until the processor sends its graph
+  compile(makePresetGraph(0), plans[(size_t)audioPlan]);
+  activeEffects = plans[(size_t)audioPlan].effectMask;
+  graphEffects = activeEffects;
 }
 
 EffectsProcessor::~EffectsProcessor() {}
@@ -15,119 +14,296 @@ void EffectsProcessor::prepare(juce::dsp::ProcessSpec &spec) {
 
   // Prepare Distortion
   distortion.prepare(spec);
-  distDriveParam.reset(currentSampleRate, 0.05); // 50ms ramp
-  distMixParam.reset(currentSampleRate, 0.05);
+
+  bitcrusher.prepare(spec);
 
   // Prepare Transient Shaper
   transientShaper.prepare(spec);
 
-  // Prepare Delay
-  delayLine.prepare(spec);
-  // Important: Set correct max delay based on sample rate
-  delayLine.setMaximumDelayInSamples(
-      static_cast<int>(spec.sampleRate * maxDelayTime));
-  delayLine.reset();
-
-  delayTimeParam.reset(currentSampleRate,
-                       0.5); // Slower ramp for delay time to avoid pitch jumps?
-                             // Actually fast ramp + interpolation is better for
-                             // "swoop". 0.05 is standard.
-  delayTimeParam.reset(currentSampleRate, 0.05);
-  delayFeedbackParam.reset(currentSampleRate, 0.05);
-  delayMixParam.reset(currentSampleRate, 0.05);
+  // Prepare Delay (line sized for the longest synced time)
+  delay.prepare(spec.sampleRate, (int)spec.maximumBlockSize);
 
   // Prepare Reverb
-  reverb.prepare(spec);
-  reverb.reset();
-  reverbMixParam.reset(currentSampleRate, 0.05);
-
-  // Prepare Analysis Filters
-  meterFilterLow.prepare(spec);
-  meterFilterLow.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-  meterFilterLow.setCutoffFrequency(300.0f); // Low band < 300Hz
-
-  meterFilterMid.prepare(spec);
-  meterFilterMid.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-  meterFilterMid.setCutoffFrequency(1000.0f); // Mid band center 1kHz
-
-  meterFilterHigh.prepare(spec);
-  meterFilterHigh.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-  meterFilterHigh.setCutoffFrequency(5000.0f); // High band > 5kHz
+  reverb.prepare(spec.sampleRate, (int)spec.maximumBlockSize);
+  convolution.prepare(spec.sampleRate, (int)spec.maximumBlockSize);
+
+  // Prepare Analysis (Low < 300Hz, Mid around 1kHz, High > 5kHz)
+  meter.prepare(spec.sampleRate);
+
+  // Compensation lines, long enough for the largest latency either latent
+  // effect can have
+  const int channels = juce::jmax(1, (int)spec.numChannels);
+  const int shaperLatency = TransientShaper::getLookaheadSamples(
+      TransientShaper::maxLookaheadMs, spec.sampleRate);
+  int distLatency = 0;
+  for (int index = 0; index <= 3; ++index)
+    distLatency = juce::jmax(distLatency, distortion.getLatencySamples(index));
+  const int maxLatency = juce::jmax(shaperLatency, distLatency);
+  maxLatencySamples = shaperLatency + distLatency; // Both in series
+  for (auto &line : compensation) {
+    line.setSize(channels, maxLatency + (int)spec.maximumBlockSize);
+    line.clear();
+  }
+  compensationDelay.fill(0);
 
-  // Reserve ramp buffer
-  rampBuffer.reserve(spec.maximumBlockSize);
+  // Graph scratch: the host buffer is buffer 0, the rest live here
+  for (int b = mainBuffer + 1; b < numBuffers; ++b)
+    scratch[(size_t)b].setSize(channels, (int)spec.maximumBlockSize);
 }
 
 void EffectsProcessor::reset() {
   distortion.reset();
   transientShaper.reset();
-  delayLine.reset();
+  for (auto &line : compensation)
+    line.clear();
+  delay.reset();
   reverb.reset();
+  convolution.reset();
 
-  meterFilterLow.reset();
-  meterFilterMid.reset();
-  meterFilterHigh.reset();
-  bitcrushPhase = 0.0f;
-  lastCrushedSampleL = 0.0f;
-  lastCrushedSampleR = 0.0f;
+  meter.reset();
+  bitcrusher.reset();
+
+  for (auto &tail : tails) {
+    tail.silentSamples = 0;
+    tail.asleep = false;
+  }
 
   // Reset smoothers to target ?? No, usually just keep current.
 }
 
-void EffectsProcessor::updateParameters(float distDrive, float distMix,
-                                        float delayTime, float delayFeedback,
-                                        float delayMix, float reverbSize,
-                                        float reverbDamping, float reverbMix,
-                                        float biteAmount) {
-  distDriveParam.setTargetValue(distDrive);
-  distMixParam.setTargetValue(distMix);
-  transientShaper.setAmount(biteAmount); // Shaper handles its own smoothing
+void EffectsProcessor::updateParameters(const Parameters &newParams) {
+  distDriveTarget = newParams.distDrive; // Hunt boost applied per block
+  huntEnabled = newParams.hunt;
+  distortion.setMix(newParams.distMix);
+  distortion.setOversampling(newParams.distOversampling);
+
+  Bitcrusher::Parameters crushParams;
+  crushParams.bits = newParams.crushBits;
+  crushParams.rateHz = newParams.crushRate;
+  crushParams.mix = newParams.crushMix;
+  crushParams.dither = newParams.crushDither;
+  crushParams.antiAlias = newParams.crushAntiAlias;
+  bitcrusher.setParameters(crushParams);
+
+  TransientShaper::Parameters shaperParams;
+  shaperParams.attack = newParams.biteAmount;
+  shaperParams.sustain = newParams.biteSustain;
+  shaperParams.lookaheadMs = newParams.biteLookahead;
+  transientShaper.setParameters(shaperParams);
+
+  StereoDelay::Parameters delayParams;
+  delayParams.timeSeconds = newParams.delayTime;
+  delayParams.sync = newParams.delaySync;
+  delayParams.division = newParams.delayDivision;
+  delayParams.bpm = newParams.bpm;
+  delayParams.feedback = newParams.delayFeedback;
+  delayParams.mix = newParams.delayMix;
+  delayParams.width = newParams.delayWidth;
+  delayParams.tone = newParams.delayTone;
+  delayParams.pingPong = newParams.delayPingPong;
+  delay.setParameters(delayParams);
+
+  FdnReverb::Parameters reverbParams;
+  reverbParams.size = newParams.reverbSize;
+  reverbParams.decay = newParams.reverbDecay;
+  reverbParams.damping = newParams.reverbDamping;
+  reverbParams.mix = newParams.reverbMix;
+  reverb.setParameters(reverbParams);
 
-  delayTimeParam.setTargetValue(delayTime);
-  delayFeedbackParam.setTargetValue(delayFeedback);
-  delayMixParam.setTargetValue(delayMix);
+  ConvolutionReverb::Parameters convolutionParams;
+  convolutionParams.mix = newParams.convolutionMix;
+  convolutionParams.offline = newParams.offline;
+  convolution.setParameters(convolutionParams);
 
-  // Map Reverb params
-  reverbParams.roomSize = reverbSize;
-  reverbParams.damping = reverbDamping;
+  updateTails();
+}
 
-  // Revert to internal mixing to ensure Dry/Wet balance works without temp
-  // buffer
-  reverbParams.wetLevel = reverbMix;
-  reverbParams.dryLevel = 1.0f - reverbMix;
+//==============================================================================
+EffectsProcessor::Graph EffectsProcessor::makePresetGraph(int preset) {
+  using ET = EffectType;
+  std::array<ET, 4> order;
+
+  // Standard: Dist -> Bite -> Delay -> Reverb
+  // Ethereal: Reverb -> Delay -> Dist -> Bite
+  // Chaos: Delay -> Dist -> Bite -> Reverb
+  // Reverse: Reverb -> Delay -> Bite -> Dist
+
+  switch (preset) {
+  default:
+  case 0:
+    order = {ET::Distortion, ET::TransientShaper, ET::Delay, ET::Reverb};
+    break;
+  case 1:
+    order = {ET::Reverb, ET::Delay, ET::Distortion, ET::TransientShaper};
+    break;
+  case 2:
+    order = {ET::Delay, ET::Distortion, ET::TransientShaper, ET::Reverb};
+    break;
+  case 3:
+    order = {ET::Reverb, ET::Delay, ET::TransientShaper, ET::Distortion};
+    break;
+  }
 
-  reverbParams.width = 1.0f;
-  reverbParams.freezeMode = 0.0f;
+  Graph graph;
+  for (size_t i = 0; i < order.size(); ++i)
+    graph[i].type = order[i];
+  return graph;
+}
 
-  reverb.setParameters(reverbParams);
-  reverbMixParam.setTargetValue(
-      reverbMix); // Keep for the on/off check in processReverb
+void EffectsProcessor::compile(const Graph &graph, Plan &plan) {
+  plan.numSteps = 0;
+  plan.effectMask = 0;
+  plan.latentInOneGroup = false;
+
+  auto add = [&plan](Step::Op op, EffectType effect, int source, int dest,
+                     float gain, juce::uint32 group = 0) {
+    jassert(plan.numSteps < maxSteps);
+    auto &step = plan.steps[(size_t)plan.numSteps++];
+    step.op = op;
+    step.effect = effect;
+    step.source = source;
+    step.dest = dest;
+    step.gain = gain;
+    step.group = group;
+  };
+
+  // Effects that can delay their output (oversampling, look-ahead)
+  constexpr auto latentMask = (1u << (int)EffectType::Distortion) |
+                              (1u << (int)EffectType::TransientShaper);
+
+  // 1. Live slots only: empty, bypassed and fully dry slots cost nothing.
+  //    The first slot holding an effect wins (one instance per effect).
+  std::array<Slot, maxSlots> live;
+  int numLive = 0;
+  for (const auto &slot : graph) {
+    if (slot.type == EffectType::None || slot.bypassed || slot.mix < 1.0e-4f)
+      continue;
+
+    const auto bit = 1u << (int)slot.type;
+    if ((plan.effectMask & bit) != 0)
+      continue;
+
+    plan.effectMask |= bit;
+    live[(size_t)numLive++] = slot;
+  }
+
+  // 2. Groups: a slot plus the parallel slots right after it
+  using Op = Step::Op;
+  constexpr auto none = EffectType::None;
+
+  for (int first = 0; first < numLive;) {
+    int end = first + 1;
+    while (end < numLive && live[(size_t)end].parallel)
+      ++end;
+
+    if (end - first == 1) {
+      const auto &slot = live[(size_t)first];
+      if (slot.type == EffectType::TransientShaper) {
+        // Mixes itself, against its look-ahead-delayed input
+        add(Op::Run, slot.type, mainBuffer, mainBuffer, slot.mix);
+      } else if (slot.mix >= 0.9999f) {
+        add(Op::Run, slot.type, mainBuffer, mainBuffer, 1.0f);
+      } else {
+        // The dry copy is delayed to match the effect's own latency
+        add(Op::Copy, none, mainBuffer, dryBuffer, 1.0f);
+        add(Op::Run, slot.type, mainBuffer, mainBuffer, 1.0f);
+        if (((1u << (int)slot.type) & latentMask) != 0)
+          add(Op::Compensate, slot.type, dryBuffer, dryBuffer, 1.0f);
+        add(Op::Blend, none, dryBuffer, mainBuffer, slot.mix);
+      }
+    } else {
+      // Every branch gets the group input; the outputs are averaged
+      const float weight = 1.0f / (float)(end - first);
+      add(Op::Copy, none, mainBuffer, inputBuffer, 1.0f);
+      add(Op::Clear, none, sumBuffer, sumBuffer, 1.0f);
+
+      // With a latent effect in the group, every branch is delayed to the
+      // group's longest latency before it is summed
+      juce::uint32 group = 0;
+      for (int s = first; s < end; ++s)
+        group |= 1u << (int)live[(size_t)s].type;
+      const bool aligned = (group & latentMask) != 0;
+      if ((group & latentMask) == latentMask)
+        plan.latentInOneGroup = true;
+
+      for (int s = first; s < end; ++s) {
+        const auto &slot = live[(size_t)s];
+        add(Op::Copy, none, inputBuffer, branchBuffer, 1.0f);
+        if (slot.type == EffectType::TransientShaper) {
+          add(Op::Run, slot.type, branchBuffer, branchBuffer, slot.mix);
+        } else {
+          add(Op::Run, slot.type, branchBuffer, branchBuffer, 1.0f);
+          if (slot.mix < 0.9999f) {
+            add(Op::Copy, none, inputBuffer, dryBuffer, 1.0f);
+            if (((1u << (int)slot.type) & latentMask) != 0)
+              add(Op::Compensate, slot.type, dryBuffer, dryBuffer, 1.0f);
+            add(Op::Blend, none, dryBuffer, branchBuffer, slot.mix);
+          }
+        }
+        if (aligned)
+          add(Op::Compensate, slot.type, branchBuffer, branchBuffer, 1.0f,
+              group);
+        add(Op::Accumulate, none, branchBuffer, sumBuffer, weight);
+      }
+
+      add(Op::Copy, none, sumBuffer, mainBuffer, 1.0f);
+    }
+
+    first = end;
+  }
 }
 
+void EffectsProcessor::updateTails() {
+  // Distortion / crusher and the shaper only ring for their filters and
+  // envelopes; the time-based effects report their own
+  tails[(size_t)EffectType::Distortion].tailSeconds =
+      0.01f + (float)distortion.getLatencySamples() / (float)currentSampleRate;
+  tails[(size_t)EffectType::TransientShaper].tailSeconds =
+      0.1f + (float)transientShaper.getLatencySamples() /
+                 (float)currentSampleRate;
+  tails[(size_t)EffectType::Delay].tailSeconds = delay.getTailSeconds();
+  tails[(size_t)EffectType::Reverb].tailSeconds =
+      juce::jmax(reverb.getTailSeconds(), convolution.getTailSeconds());
+
+  float total = 0.0f;
+  for (int type = 1; type < numEffectTypes; ++type)
+    if ((activeEffects & (1u << type)) != 0)
+      total += tails[(size_t)type].tailSeconds;
+  graphTailSeconds = total;
+}
+
+void EffectsProcessor::setGraph(const Graph &graph) {
+  compile(graph, plans[(size_t)writerPlan]);
+  graphEffects = plans[(size_t)writerPlan].effectMask;
+  graphLatentInOneGroup = plans[(size_t)writerPlan].latentInOneGroup;
+  writerPlan = sharedPlan.exchange(writerPlan | newPlanFlag,
+                                   std::memory_order_acq_rel) &
+               (newPlanFlag - 1);
+}
+
+//==============================================================================
 void EffectsProcessor::process(juce::AudioBuffer<float> &buffer) {
   juce::ScopedNoDenormals noDenormals;
 
-  for (auto effect : chainOrder) {
-    switch (effect) {
-    case EffectType::Distortion:
-      processDistortion(buffer);
-      // Bitcrusher is logically part of Distortion block in this context
-      if (bitcrushEnabled) {
-        processBitcrusher(buffer);
-      }
-      break;
-    case EffectType::TransientShaper:
-      processTransientShaper(buffer);
-      break;
-    case EffectType::Delay:
-      processDelay(buffer);
-      break;
-    case EffectType::Reverb:
-      processReverb(buffer);
-      break;
-    }
+  // Pick up a newly compiled graph
+  if ((sharedPlan.load(std::memory_order_relaxed) & newPlanFlag) != 0) {
+    audioPlan =
+        sharedPlan.exchange(audioPlan, std::memory_order_acq_rel) &
+        (newPlanFlag - 1);
+
+    // Effects coming (back) into the graph start from clean state rather
+    // than whatever they held when they were taken out
+    const auto mask = plans[(size_t)audioPlan].effectMask;
+    const auto added = mask & ~activeEffects;
+    for (int type = 1; type < numEffectTypes; ++type)
+      if ((added & (1u << type)) != 0)
+        resetEffect((EffectType)type);
+    activeEffects = mask;
+    updateTails();
   }
 
+  executePlan(plans[(size_t)audioPlan], buffer);
+
   // Metering after all effects (or strictly after distortion? User said
   // "DISTORTION EQ") But if it's "Effects Tab" metering, user probably wants to
   // see the overall spectrum. However, "DISTORTION EQ" implies it visualizes
@@ -141,158 +317,250 @@ void EffectsProcessor::process(juce::AudioBuffer<float> &buffer) {
   processMetering(buffer);
 }
 
-void EffectsProcessor::processBitcrusher(juce::AudioBuffer<float> &buffer) {
-  // Simple Bitcrush/Downsample
-  // Downsample factor: 4x (roughly 11kHz SR)
-  // Bit depth: 8 bit via truncation
-  float downsampleFactor = 4.0f;
-  int numSamples = buffer.getNumSamples();
-  auto *ch0 = buffer.getWritePointer(0);
-  auto *ch1 = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
-
-  for (int i = 0; i < numSamples; ++i) {
-    bitcrushPhase += 1.0f;
-    if (bitcrushPhase >= downsampleFactor) {
-      bitcrushPhase -= downsampleFactor;
-
-      // Quantize
-      float sample = ch0[i];
-      float levels = 256.0f; // 8 bit
-      sample = std::round(sample * levels) / levels;
-      lastCrushedSampleL = sample;
-
-      if (ch1) {
-        float sampleR = ch1[i];
-        sampleR = std::round(sampleR * levels) / levels;
-        lastCrushedSampleR = sampleR;
-      }
+void EffectsProcessor::executePlan(const Plan &plan,
+                                   juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int channels =
+      juce::jmin(buffer.getNumChannels(), scratch[dryBuffer].getNumChannels());
+  if (numSamples == 0 || channels == 0)
+    return;
+
+  // Larger than prepared (should not happen): no scratch, run in series
+  if (numSamples > scratch[dryBuffer].getNumSamples()) {
+    for (int i = 0; i < plan.numSteps; ++i)
+      if (plan.steps[(size_t)i].op == Step::Op::Run)
+        runEffect(plan.steps[(size_t)i].effect, buffer,
+                  plan.steps[(size_t)i].gain);
+    return;
+  }
+
+  std::array<juce::AudioBuffer<float> *, numBuffers> buffers;
+  buffers[mainBuffer] = &buffer;
+  for (int b = mainBuffer + 1; b < numBuffers; ++b) {
+    auto &view = views[(size_t)b];
+    view.setDataToReferTo(scratch[(size_t)b].getArrayOfWritePointers(),
+                          channels, numSamples);
+    buffers[(size_t)b] = &view;
+  }
+
+  using FVO = juce::FloatVectorOperations;
+
+  for (int i = 0; i < plan.numSteps; ++i) {
+    const auto &step = plan.steps[(size_t)i];
+    auto &dest = *buffers[(size_t)step.dest];
+    const auto &source = *buffers[(size_t)step.source];
+
+    if (step.op == Step::Op::Run) {
+      runEffect(step.effect, dest, step.gain);
+      continue;
+    }
+    if (step.op == Step::Op::Compensate) {
+      compensate(step, dest);
+      continue;
     }
 
-    ch0[i] = lastCrushedSampleL;
-    if (ch1)
-      ch1[i] = lastCrushedSampleR;
+    for (int ch = 0; ch < channels; ++ch) {
+      auto *d = dest.getWritePointer(ch);
+      const auto *s = source.getReadPointer(ch);
+
+      switch (step.op) {
+      case Step::Op::Copy:
+        FVO::copy(d, s, numSamples);
+        break;
+      case Step::Op::Blend:
+        FVO::subtract(d, s, numSamples);
+        FVO::multiply(d, step.gain, numSamples);
+        FVO::add(d, s, numSamples);
+        break;
+      case Step::Op::Clear:
+        FVO::clear(d, numSamples);
+        break;
+      case Step::Op::Accumulate:
+        FVO::addWithMultiply(d, s, step.gain, numSamples);
+        break;
+      case Step::Op::Run:
+      case Step::Op::Compensate:
+        break;
+      }
+    }
   }
 }
 
-void EffectsProcessor::processMetering(const juce::AudioBuffer<float> &buffer) {
-  // Copy buffer for non-destructive analysis
-  juce::AudioBuffer<float> scratch;
-  scratch.makeCopyOf(buffer);
-
-  juce::dsp::AudioBlock<float> block(scratch);
-  juce::dsp::ProcessContextReplacing<float> context(block);
-
-  // Apply bands and measure RMS
-  // To measure bands independently, we need 3 copies or process sequentially on
-  // distinct buffers? StateVariableFilter processes in place.
-  // 1. Low Band
-  {
-    juce::AudioBuffer<float> lowBuf;
-    lowBuf.makeCopyOf(buffer);
-    juce::dsp::AudioBlock<float> lowBlock(lowBuf);
-    juce::dsp::ProcessContextReplacing<float> lowCtx(lowBlock);
-    meterFilterLow.process(lowCtx);
-    eqLow = lowBuf.getRMSLevel(0, 0, lowBuf.getNumSamples()) *
-            5.0f; // Signal is likely quiet after filtering, boost range
+void EffectsProcessor::runEffect(EffectType type,
+                                 juce::AudioBuffer<float> &buffer, float mix) {
+  auto &tail = tails[(size_t)type];
+  const int numSamples = buffer.getNumSamples();
+
+  if (buffer.getMagnitude(0, numSamples) > silenceThreshold) {
+    tail.silentSamples = 0; // Input: wake up (or stay awake)
+    tail.asleep = false;
+  } else if (tail.asleep) {
+    return;
+  } else {
+    tail.silentSamples += numSamples;
   }
-  // 2. Mid Band
-  {
-    juce::AudioBuffer<float> midBuf;
-    midBuf.makeCopyOf(buffer);
-    juce::dsp::AudioBlock<float> midBlock(midBuf);
-    juce::dsp::ProcessContextReplacing<float> midCtx(midBlock);
-    meterFilterMid.process(midCtx);
-    eqMid = midBuf.getRMSLevel(0, 0, midBuf.getNumSamples()) * 5.0f;
-  }
-  // 3. High Band
-  {
-    juce::AudioBuffer<float> highBuf;
-    highBuf.makeCopyOf(buffer);
-    juce::dsp::AudioBlock<float> highBlock(highBuf);
-    juce::dsp::ProcessContextReplacing<float> highCtx(highBlock);
-    meterFilterHigh.process(highCtx);
-    eqHigh = highBuf.getRMSLevel(0, 0, highBuf.getNumSamples()) * 5.0f;
+
+  switch (type) {
+  case EffectType::Distortion:
+    processDistortion(buffer);
+    // Bitcrusher is logically part of Distortion block in this context
+    processBitcrusher(buffer);
+    break;
+  case EffectType::TransientShaper:
+    processTransientShaper(buffer, mix);
+    break;
+  case EffectType::Delay:
+    processDelay(buffer);
+    break;
+  case EffectType::Reverb:
+    processReverb(buffer);
+    break;
+  case EffectType::None:
+    break;
   }
+
+  // Quiet for the whole tail and nothing left coming out: go to sleep
+  if (tail.silentSamples > 0 &&
+      (double)tail.silentSamples >= tail.tailSeconds * currentSampleRate &&
+      buffer.getMagnitude(0, numSamples) < silenceThreshold)
+    tail.asleep = true;
 }
 
-void EffectsProcessor::processDistortion(juce::AudioBuffer<float> &buffer) {
-  auto totalNumInputChannels = buffer.getNumChannels();
-  auto numSamples = buffer.getNumSamples();
+void EffectsProcessor::resetEffect(EffectType type) {
+  switch (type) {
+  case EffectType::Distortion:
+    distortion.reset();
+    bitcrusher.reset();
+    break;
+  case EffectType::TransientShaper:
+    transientShaper.reset();
+    break;
+  case EffectType::Delay:
+    delay.reset();
+    break;
+  case EffectType::Reverb:
+    reverb.reset();
+    convolution.reset();
+    break;
+  case EffectType::None:
+    break;
+  }
 
-  auto *ch0 = buffer.getWritePointer(0);
-  auto *ch1 = (totalNumInputChannels > 1) ? buffer.getWritePointer(1) : nullptr;
+  tails[(size_t)type].silentSamples = 0;
+  tails[(size_t)type].asleep = false;
+}
 
-  for (int i = 0; i < numSamples; ++i) {
-    float drive = distDriveParam.getNextValue();
-    float mix = distMixParam.getNextValue();
+void EffectsProcessor::processBitcrusher(juce::AudioBuffer<float> &buffer) {
+  // Fades in / out with its mix (bitcrushOn, Crush macro); skips when dry
+  bitcrusher.process(buffer);
+}
 
-    // Hunt Mode Logic ("Hunt" button essentially boosts Input Drive)
-    if (huntEnabled) {
-      drive = std::min(drive * 1.5f + 0.2f, 1.0f);
-    }
+void EffectsProcessor::processMetering(const juce::AudioBuffer<float> &buffer) {
+  // Nobody is watching: skip the analysis entirely
+  const bool enabled = meteringEnabled.load(std::memory_order_relaxed);
+  if (!enabled) {
+    wasMetering = false;
+    return;
+  }
 
-    float gain = 1.0f + (drive * 49.0f);
+  // Editor just opened: start from clean filters, not stale state
+  if (!wasMetering) {
+    meter.reset();
+    wasMetering = true;
+  }
 
-    float dry0 = ch0[i];
-    float wet0 = std::tanh(dry0 * gain);
-    ch0[i] = (dry0 * (1.0f - mix)) + (wet0 * mix);
+  meter.process(buffer);
+}
 
-    if (ch1) {
-      float dry1 = ch1[i];
-      float wet1 = std::tanh(dry1 * gain);
-      ch1[i] = (dry1 * (1.0f - mix)) + (wet1 * mix);
-    }
+void EffectsProcessor::processDistortion(juce::AudioBuffer<float> &buffer) {
+  // Hunt Mode Logic ("Hunt" button essentially boosts Input Drive)
+  float drive = distDriveTarget;
+  if (huntEnabled) {
+    drive = std::min(drive * 1.5f + 0.2f, 1.0f);
   }
+
+  distortion.setDrive(drive);
+  distortion.process(buffer);
 }
 
 void EffectsProcessor::processTransientShaper(
-    juce::AudioBuffer<float> &buffer) {
+    juce::AudioBuffer<float> &buffer, float mix) {
+  transientShaper.setMix(mix);
   transientShaper.process(buffer);
 }
 
-void EffectsProcessor::processDelay(juce::AudioBuffer<float> &buffer) {
-  auto totalNumInputChannels = buffer.getNumChannels();
-  auto numSamples = buffer.getNumSamples();
-
-  auto *ch0 = buffer.getWritePointer(0);
-  auto *ch1 = (totalNumInputChannels > 1) ? buffer.getWritePointer(1) : nullptr;
-
-  for (int i = 0; i < numSamples; ++i) {
-    float time = delayTimeParam.getNextValue();
-    float fdbk = delayFeedbackParam.getNextValue();
-    float mix = delayMixParam.getNextValue();
+int EffectsProcessor::getLatencySamples(int distOversampling,
+                                        float lookaheadMs) const {
+  const int distLatency = isInGraph(EffectType::Distortion)
+                              ? distortion.getLatencySamples(distOversampling)
+                              : 0;
+  const int shaperLatency =
+      isInGraph(EffectType::TransientShaper)
+          ? TransientShaper::getLookaheadSamples(lookaheadMs,
+                                                 currentSampleRate)
+          : 0;
+  return graphLatentInOneGroup.load() ? juce::jmax(distLatency, shaperLatency)
+                                      : distLatency + shaperLatency;
+}
 
-    float delaySamples = time * (float)currentSampleRate;
-    delaySamples = juce::jlimit(1.0f, (float)(maxDelayTime * currentSampleRate),
-                                delaySamples);
+int EffectsProcessor::getEffectLatency(EffectType type) const {
+  switch (type) {
+  case EffectType::Distortion:
+    return distortion.getLatencySamples();
+  case EffectType::TransientShaper:
+    return transientShaper.getLatencySamples();
+  default:
+    return 0;
+  }
+}
 
-    delayLine.setDelay(delaySamples);
+void EffectsProcessor::compensate(const Step &step,
+                                  juce::AudioBuffer<float> &buffer) {
+  // Dry copy: the effect's own latency. Parallel branch: whatever it lacks
+  // of the group's longest latency.
+  int delaySamples = getEffectLatency(step.effect);
+  size_t index = (size_t)step.effect;
+  if (step.group != 0) {
+    int groupLatency = 0;
+    for (int type = 1; type < numEffectTypes; ++type)
+      if ((step.group & (1u << type)) != 0)
+        groupLatency =
+            juce::jmax(groupLatency, getEffectLatency((EffectType)type));
+    delaySamples = groupLatency - delaySamples;
+    index += (size_t)numEffectTypes;
+  }
 
-    {
-      float input = ch0[i];
-      float delayed = delayLine.popSample(0, -1.0f);
-      float fbSignal = input + (delayed * fdbk);
-      delayLine.pushSample(0, fbSignal);
-      ch0[i] = input + (delayed * mix);
-    }
+  // A new amount restarts the line (a click, like any latency change)
+  auto &line = compensation[index];
+  if (delaySamples != compensationDelay[index]) {
+    compensationDelay[index] = delaySamples;
+    line.clear();
+  }
 
-    if (ch1) {
-      float input = ch1[i];
-      float delayed = delayLine.popSample(1, -1.0f);
-      float fbSignal = input + (delayed * fdbk);
-      delayLine.pushSample(1, fbSignal);
-      ch1[i] = input + (delayed * mix);
-    }
+  const int numSamples = buffer.getNumSamples();
+  const int channels =
+      juce::jmin(buffer.getNumChannels(), line.getNumChannels());
+  if (delaySamples <= 0 || numSamples + delaySamples > line.getNumSamples())
+    return;
+
+  // Same layout as the shaper's own delay: [carried samples | this block]
+  for (int ch = 0; ch < channels; ++ch) {
+    auto *history = line.getWritePointer(ch);
+    auto *data = buffer.getWritePointer(ch);
+    juce::FloatVectorOperations::copy(history + delaySamples, data,
+                                      numSamples);
+    juce::FloatVectorOperations::copy(data, history, numSamples);
+    std::memmove(history, history + numSamples,
+                 sizeof(float) * (size_t)delaySamples);
   }
 }
 
+void EffectsProcessor::processDelay(juce::AudioBuffer<float> &buffer) {
+  delay.process(buffer);
+}
+
 void EffectsProcessor::processReverb(juce::AudioBuffer<float> &buffer) {
-  // Use TargetValue because we are using block-based mixing via setParameters,
-  // so the Smoother isn't technically advanced per sample, but Target holds
-  // current setting.
-  if (reverbMixParam.getTargetValue() > 0.0f) {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    reverb.process(context);
-  }
+  // Both skip themselves while fully dry
+  reverb.process(buffer);
+  convolution.process(buffer);
 }
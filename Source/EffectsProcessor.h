@@ -1,11 +1,17 @@
 #pragma once
 
+#include "BandMeter.h"
+#include "Bitcrusher.h"
+#include "ConvolutionReverb.h"
+#include "Distortion.h"
+#include "FdnReverb.h"
+#include "StereoDelay.h"
 #include "TransientShaper.h"
 #include <JuceHeader.h>
 
 class EffectsProcessor {
 public:
-  enum class EffectType { Distortion, TransientShaper, Delay, Reverb };
+  enum class EffectType { None, Distortion, TransientShaper, Delay, Reverb };
 
   EffectsProcessor();
   ~EffectsProcessor();
@@ -14,84 +20,226 @@ public:
   void process(juce::AudioBuffer<float> &buffer);
   void reset();
 
-  void setChainOrder(const std::array<EffectType, 4> &newOrder) {
-    chainOrder = newOrder;
+  // --- Effects graph ---
+  // Up to maxSlots slots, each holding any effect (each effect at most once:
+  // there is one instance of each). Consecutive slots flagged parallel share
+  // their input and their outputs are averaged; everything else runs in
+  // series. Empty and bypassed slots are left out of the compiled plan.
+  static constexpr int maxSlots = 8;
+
+  struct Slot {
+    EffectType type = EffectType::None;
+    bool bypassed = false;
+    float mix = 1.0f;      // Slot wet / dry, on top of the effect's own mix
+    bool parallel = false; // Runs alongside the slot before it
+  };
+  using Graph = std::array<Slot, maxSlots>;
+
+  // The four CHAIN_ORDER presets (Standard, Ethereal, Chaos, Reverse)
+  static Graph makePresetGraph(int preset);
+
+  // Message thread: compiles the graph to a flat step list and hands it to
+  // the audio thread without locking or allocating
+  void setGraph(const Graph &graph);
+
+  // Everything the processor reads from the APVTS each block
+  struct Parameters {
+    float distDrive = 0.0f; // 0.0 - 1.0
+    float distMix = 0.0f;
+    int distOversampling = 1; // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    float crushBits = 8.0f;     // 1 - 16
+    float crushRate = 11025.0f; // Hz
+    float crushMix = 0.0f;      // 0 = off (bitcrushOn / Crush macro)
+    float crushDither = 0.0f;
+    bool crushAntiAlias = false;
+    float delayTime = 0.5f; // Seconds (free mode)
+    float delayFeedback = 0.3f;
+    float delayMix = 0.0f;
+    bool delaySync = false;
+    int delayDivision = 5; // StereoDelay::getDivisionNames()
+    float delayWidth = 1.0f;
+    float delayTone = 0.7f;
+    bool delayPingPong = false;
+    double bpm = 120.0; // Host (or standalone) tempo for synced times
+    float reverbSize = 0.5f;
+    float reverbDecay = 0.5f; // 0.3 s - 12 s
+    float reverbDamping = 0.5f;
+    float reverbMix = 0.0f;
+    float convolutionMix = 0.0f; // User IR, after the FDN
+    bool offline = false;        // Host renders faster than real time
+    float biteAmount = 0.0f;    // Attack, -1.0 - 1.0
+    float biteSustain = 0.0f;   // -1.0 - 1.0
+    float biteLookahead = 0.0f; // ms, 0 = off
+    bool hunt = false;       // Hunt mode pushes the distortion harder
+  };
+
+  void updateParameters(const Parameters &newParams);
+
+  // Longest time the graph keeps ringing after its input stops: the tails
+  // of the effects in the graph, added up (series worst case). Any thread.
+  float getTailLengthSeconds() const { return graphTailSeconds.load(); }
+
+  // Whether the last graph sent with setGraph runs this effect (any thread)
+  bool isInGraph(EffectType type) const {
+    return (graphEffects.load() & (1u << (int)type)) != 0;
   }
 
-  const std::array<EffectType, 4> &getChainOrder() const { return chainOrder; }
-
-  void updateParameters(float distDrive, float distMix, float delayTime,
-                        float delayFeedback, float delayMix, float reverbSize,
-                        float reverbDamping, float reverbMix, float biteAmount);
+  // Delay the last graph sent with setGraph adds at these settings: the
+  // distortion's oversampling filters and the shaper's look-ahead, summed
+  // in series or the larger of the two when they share a parallel group.
+  // Any thread, after prepare; the processor reports it as latency.
+  int getLatencySamples(int distOversampling, float lookaheadMs) const;
+  // The most getLatencySamples can return at the prepared rate
+  int getMaxLatencySamples() const { return maxLatencySamples; }
+
+  // User impulse response for the convolution stage (message thread; loads
+  // in the background)
+  void loadImpulseResponse(const juce::File &file) {
+    convolution.loadImpulseResponse(file);
+  }
+  void clearImpulseResponse() { convolution.clearImpulseResponse(); }
+  juce::File getImpulseResponseFile() const {
+    return convolution.getImpulseResponseFile();
+  }
+  bool isImpulseResponseLoading() const { return convolution.isLoading(); }
 
 private:
-  // Helper for smoothing
-  void generateRamp(juce::LinearSmoothedValue<float> &smoother, int numSamples);
-  std::vector<float> rampBuffer;
-
   // --- Distortion ---
-  // Use Waveshaper for standard tanh distortion (Josh Hodge style)
-  juce::LinearSmoothedValue<float> distDriveParam;
-  juce::LinearSmoothedValue<float> distMixParam;
-  juce::dsp::WaveShaper<float> distortion;
+  // Oversampled rational-tanh shaper (drive / mix smoothed per block)
+  Distortion distortion;
+  float distDriveTarget = 0.0f; // Before the Hunt boost
 
   // --- Transient Shaper ---
   TransientShaper transientShaper;
 
   // --- Delay ---
-  juce::LinearSmoothedValue<float> delayTimeParam;
-  juce::LinearSmoothedValue<float> delayFeedbackParam;
-  juce::LinearSmoothedValue<float> delayMixParam;
-
-  // Choose Lagrange for better pitch shifting/modulation support, or Linear for
-  // efficiency. Using Linear for standard echo.
-  juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear>
-      delayLine;
-  static constexpr float maxDelayTime = 2.0f;
-  std::vector<float>
-      delayFeedbackBuffer; // To store feedback values per channel
+  // Tempo-synced stereo / ping-pong echo (see StereoDelay)
+  StereoDelay delay;
 
   // --- Reverb ---
-  juce::dsp::Reverb reverb;
-  juce::dsp::Reverb::Parameters reverbParams;
-  juce::LinearSmoothedValue<float> reverbMixParam;
+  // 8-line SIMD feedback delay network (see FdnReverb)
+  FdnReverb reverb;
+  // Partitioned convolution with a user IR (see ConvolutionReverb)
+  ConvolutionReverb convolution;
 
   double currentSampleRate = 44100.0;
+  int maxLatencySamples = 0;
 
   // Helper for Dry/Wet mixing
   // We'll do simple linear mix implementation inline for clarity
 
   void processDistortion(juce::AudioBuffer<float> &buffer);
-  void processTransientShaper(juce::AudioBuffer<float> &buffer);
+  void processTransientShaper(juce::AudioBuffer<float> &buffer, float mix);
   void processDelay(juce::AudioBuffer<float> &buffer);
   void processReverb(juce::AudioBuffer<float> &buffer);
 
-  std::array<EffectType, 4> chainOrder = {
-      EffectType::Distortion, EffectType::TransientShaper, EffectType::Delay,
-      EffectType::Reverb};
+  void runEffect(EffectType type, juce::AudioBuffer<float> &buffer,
+                 float mix);
+
+  // --- Tail tracking ---
+  // Each effect sleeps once its input has been silent for longer than its
+  // tail and its output has died away too; any input above the threshold
+  // wakes it on the same block. A sleeping effect is skipped entirely
+  // (silence in, silence out).
+  static constexpr int numEffectTypes = (int)EffectType::Reverb + 1;
+  static constexpr float silenceThreshold = 1.0e-5f; // -100 dB
+
+  struct TailState {
+    float tailSeconds = 0.0f; // Known / estimated decay time
+    juce::int64 silentSamples = 0;
+    bool asleep = false;
+  };
+  std::array<TailState, numEffectTypes> tails;
+  std::atomic<float> graphTailSeconds{0.0f};
+
+  void updateTails();
+
+  // Delay each effect adds as it runs now (the distortion's oversampling
+  // filters, the shaper's look-ahead; 0 for the rest)
+  int getEffectLatency(EffectType type) const;
+
+  // Compiled graph. Buffer 0 is the host buffer, the rest are scratch.
+  enum Buffer {
+    mainBuffer,
+    dryBuffer,    // Series slot wet / dry
+    inputBuffer,  // Shared input of a parallel group
+    branchBuffer, // Parallel branch being processed
+    sumBuffer,    // Parallel group output
+    numBuffers
+  };
+
+  struct Step {
+    enum class Op {
+      Run,        // Effect on dest
+      Copy,       // source -> dest
+      Blend,      // dest = source + (dest - source) * gain (wet / dry)
+      Clear,      // dest = 0
+      Accumulate, // dest += source * gain
+      Compensate  // dest delayed to line up with a latent effect
+    };
+    Op op = Op::Run;
+    EffectType effect = EffectType::None;
+    int source = mainBuffer, dest = mainBuffer;
+    float gain = 1.0f;
+    // Compensate: 0 delays a dry copy by the effect's latency; otherwise the
+    // effects of the parallel group, and the branch of effect is delayed to
+    // the group's longest latency
+    juce::uint32 group = 0;
+  };
+
+  static constexpr int maxSteps = 7 * maxSlots + 12;
+  struct Plan {
+    std::array<Step, maxSteps> steps;
+    int numSteps = 0;
+    juce::uint32 effectMask = 0; // Bit per EffectType in the plan
+    bool latentInOneGroup = false; // Distortion and shaper run in parallel
+  };
+
+  static void compile(const Graph &graph, Plan &plan);
+  void executePlan(const Plan &plan, juce::AudioBuffer<float> &buffer);
+  void resetEffect(EffectType type);
+
+  // Triple buffer: the message thread fills writerPlan, then swaps it with
+  // sharedPlan (flagged as new); the audio thread swaps its audioPlan with
+  // sharedPlan when the flag is set. No locks, no allocation, no frees.
+  static constexpr int newPlanFlag = 4;
+  std::array<Plan, 3> plans;
+  int audioPlan = 0;
+  int writerPlan = 1;
+  std::atomic<int> sharedPlan{2};
+  juce::uint32 activeEffects = 0; // Mask of the plan the audio thread runs
+  std::atomic<juce::uint32> graphEffects{0}; // Mask of the latest setGraph
+  std::atomic<bool> graphLatentInOneGroup{false};
+
+  // Compensation delay lines, [carried samples | block] like the shaper's
+  // own: one per effect for the dry copy of its slot mix, one per effect
+  // for aligning its parallel branch
+  std::array<juce::AudioBuffer<float>, 2 * numEffectTypes> compensation;
+  std::array<int, 2 * numEffectTypes> compensationDelay{};
+  void compensate(const Step &step, juce::AudioBuffer<float> &buffer);
+
+  // Preallocated scratch (prepare) and per-block views onto it
+  std::array<juce::AudioBuffer<float>, numBuffers> scratch;
+  std::array<juce::AudioBuffer<float>, numBuffers> views;
 
   // --- Metering ---
 public:
-  // Public for easy access by Editor
-  std::atomic<float> eqLow{0.0f}, eqMid{0.0f}, eqHigh{0.0f};
+  // Latest low / mid / high levels for the editor (any thread)
+  BandMeter::Levels getMeterLevels() const { return meter.getLevels(); }
 
-  // --- New Effects ---
-  void setHuntEnabled(bool enabled) { huntEnabled = enabled; }
-  void setBitcrushEnabled(bool enabled) { bitcrushEnabled = enabled; }
+  // Metering only runs while someone is looking at it (editor open)
+  void setMeteringEnabled(bool enabled) { meteringEnabled = enabled; }
 
 private:
   bool huntEnabled = false;
-  bool bitcrushEnabled = false;
 
-  // Analysis Filters for Metering
-  juce::dsp::StateVariableTPTFilter<float> meterFilterLow;
-  juce::dsp::StateVariableTPTFilter<float> meterFilterMid;
-  juce::dsp::StateVariableTPTFilter<float> meterFilterHigh;
+  // Band analysis for the EQ bars
+  BandMeter meter;
+  std::atomic<bool> meteringEnabled{false};
+  bool wasMetering = false;
 
-  // Bitcrusher
-  float bitcrushPhase = 0.0f;
-  float lastCrushedSampleL = 0.0f;
-  float lastCrushedSampleR = 0.0f;
+  // Bitcrusher (continuous bits / rate, skipped while its mix is zero)
+  Bitcrusher bitcrusher;
 
   void processBitcrusher(juce::AudioBuffer<float> &buffer);
   void processMetering(const juce::AudioBuffer<float> &buffer);
@@ -16,14 +16,23 @@ EffectsTab::EffectsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
   setupSlider(delayFeedback, "delayFeedback", dFdbkAtt);
   setupLabel(dFdbkLabel, "FEEDBACK");
   dFdbkLabel.setFont(juce::Font(10.0f, juce::Font::bold));
-  setupSlider(delayWidth, "delayWidth",
-              dMixAtt); // Reuse Mix or leave null? Left null for safety.
+  setupSlider(delayWidth, "delayWidth", dWidthAtt);
   setupLabel(dWidthLabel, "WIDTH");
   dWidthLabel.setFont(juce::Font(10.0f, juce::Font::bold));
   setupSlider(delayMix, "delayMix", dMixAtt);
   setupLabel(dMixLabel, "MIX");
   dMixLabel.setFont(juce::Font(10.0f, juce::Font::bold));
 
+  // SYNC swaps the free time for a note division of the host tempo
+  setupButton(delaySyncBtn, "SYNC", juce::Colours::cyan);
+  dSyncAtt =
+      std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+          audioProcessor.getAPVTS(), "delaySync", delaySyncBtn);
+  setupButton(delayPingPongBtn, "PING-PONG", juce::Colours::cyan);
+  dPingPongAtt =
+      std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+          audioProcessor.getAPVTS(), "delayPingPong", delayPingPongBtn);
+
   // --- 2. BITE SECTION ---
   setupLabel(biteTitle, "BITE");
   addAndMakeVisible(biteDial);
@@ -36,6 +45,14 @@ EffectsTab::EffectsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
         std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
             audioProcessor.getAPVTS(), "BITE", biteDial);
 
+  // BITE is the attack; sustain and look-ahead sit under it
+  setupSlider(biteSustain, "biteSustain", biteSustainAtt);
+  setupLabel(biteSustainLabel, "SUSTAIN");
+  biteSustainLabel.setFont(juce::Font(10.0f, juce::Font::bold));
+  setupSlider(biteLookahead, "biteLookahead", biteLookaheadAtt);
+  setupLabel(biteLookaheadLabel, "LOOK-AHEAD");
+  biteLookaheadLabel.setFont(juce::Font(10.0f, juce::Font::bold));
+
   setupButton(huntBtn, "HUNT", juce::Colour(0xffcc0000));
   huntAtt =
       std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
@@ -53,7 +70,7 @@ EffectsTab::EffectsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
   setupSlider(revSize, "reverbSize", rSizeAtt);
   setupLabel(rSizeLabel, "SIZE");
   rSizeLabel.setFont(juce::Font(10.0f, juce::Font::bold));
-  setupSlider(revDecay, "reverbDecay", rSizeAtt); // Reuse Size or null.
+  setupSlider(revDecay, "reverbDecay", rDecayAtt);
   setupLabel(rDecayLabel, "DECAY");
   rDecayLabel.setFont(juce::Font(10.0f, juce::Font::bold));
   setupSlider(revDamp, "reverbDamping", rDampAtt);
@@ -63,12 +80,52 @@ EffectsTab::EffectsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
   setupLabel(rMixLabel, "MIX");
   rMixLabel.setFont(juce::Font(10.0f, juce::Font::bold));
 
+  // Convolution: user impulse response after the algorithmic reverb
+  setupSlider(convMix, "convMix", convMixAtt);
+  setupLabel(convMixLabel, "IR MIX");
+  convMixLabel.setFont(juce::Font(10.0f, juce::Font::bold));
+  addAndMakeVisible(loadIrBtn);
+  loadIrBtn.setColour(juce::TextButton::buttonColourId,
+                      juce::Colours::cyan.withAlpha(0.3f));
+  loadIrBtn.onClick = [this] { browseImpulseResponse(); };
+  updateImpulseResponseButton();
+
   startTimerHz(60);
 }
 
 EffectsTab::~EffectsTab() { stopTimer(); }
 
-void EffectsTab::timerCallback() { repaint(); }
+void EffectsTab::timerCallback() {
+  updateImpulseResponseButton();
+  repaint();
+}
+
+void EffectsTab::browseImpulseResponse() {
+  irChooser = std::make_unique<juce::FileChooser>(
+      "Select Impulse Response",
+      juce::File::getSpecialLocation(juce::File::userMusicDirectory),
+      "*.wav;*.aif;*.aiff;*.flac");
+
+  irChooser->launchAsync(juce::FileBrowserComponent::openMode |
+                             juce::FileBrowserComponent::canSelectFiles,
+                         [this](const juce::FileChooser &fc) {
+                           auto file = fc.getResult();
+                           if (file.existsAsFile())
+                             audioProcessor.loadImpulseResponse(file);
+                         });
+}
+
+void EffectsTab::updateImpulseResponseButton() {
+  juce::String text = "LOAD IR";
+  if (audioProcessor.isImpulseResponseLoading())
+    text = "LOADING...";
+  else if (auto file = audioProcessor.getImpulseResponseFile();
+           file != juce::File())
+    text = file.getFileNameWithoutExtension().toUpperCase();
+
+  if (loadIrBtn.getButtonText() != text)
+    loadIrBtn.setButtonText(text);
+}
 
 void EffectsTab::setupSlider(
     juce::Slider &s, const juce::String &paramId,
@@ -134,9 +191,11 @@ void EffectsTab::drawEQBars(juce::Graphics &g) {
 
   // Get Values
   // Range is 0-1, maybe higher if boosted. Clamp for display.
-  float lo = juce::jlimit(0.0f, 1.0f, audioProcessor.getEqLow());
-  float mid = juce::jlimit(0.0f, 1.0f, audioProcessor.getEqMid());
-  float hi = juce::jlimit(0.0f, 1.0f, audioProcessor.getEqHigh());
+  // One snapshot so the three bars come from the same window
+  const auto levels = audioProcessor.getMeterLevels();
+  float lo = juce::jlimit(0.0f, 1.0f, levels.low);
+  float mid = juce::jlimit(0.0f, 1.0f, levels.mid);
+  float hi = juce::jlimit(0.0f, 1.0f, levels.high);
 
   float values[] = {lo, mid, hi};
 
@@ -233,6 +292,11 @@ void EffectsTab::resized() {
   placeRow(delayWidth, dWidthLabel);
   placeRow(delayMix, dMixLabel);
 
+  auto buttonRow = dArea.removeFromTop(30).reduced(0, 3);
+  delaySyncBtn.setBounds(
+      buttonRow.removeFromLeft(buttonRow.getWidth() / 2).reduced(2, 0));
+  delayPingPongBtn.setBounds(buttonRow.reduced(2, 0));
+
   // Reverb
   auto rArea = reverbPanel.reduced(15);
   reverbTitle.setBounds(rArea.removeFromTop(30));
@@ -247,6 +311,8 @@ void EffectsTab::resized() {
   placeRowRev(revDecay, rDecayLabel);
   placeRowRev(revDamp, rDampLabel);
   placeRowRev(revMix, rMixLabel);
+  placeRowRev(convMix, convMixLabel);
+  loadIrBtn.setBounds(rArea.removeFromTop(30).reduced(2, 3));
 
   // Position Center Controls
   auto bArea = bitePanel.reduced(10);
@@ -265,6 +331,13 @@ void EffectsTab::resized() {
   huntBtn.setBounds(btnArea.removeFromLeft(btnArea.getWidth() / 2).reduced(5));
   bitcrushBtn.setBounds(btnArea.reduced(5));
 
+  auto shapeArea = bArea.removeFromBottom(36);
+  auto sustainArea = shapeArea.removeFromLeft(shapeArea.getWidth() / 2);
+  biteSustainLabel.setBounds(sustainArea.removeFromTop(14));
+  biteSustain.setBounds(sustainArea.reduced(4, 0));
+  biteLookaheadLabel.setBounds(shapeArea.removeFromTop(14));
+  biteLookahead.setBounds(shapeArea.reduced(4, 0));
+
   // Dial takes remaining centered space
   // Dial takes remaining centered space
   biteDial.setBounds(bArea.withSizeKeepingCentre(100, 100));
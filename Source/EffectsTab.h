@@ -23,6 +23,8 @@ private:
   void setupLabel(juce::Label &l, const juce::String &t);
   void setupButton(juce::TextButton &b, const juce::String &t, juce::Colour c);
   void drawEQBars(juce::Graphics &g);
+  void browseImpulseResponse();
+  void updateImpulseResponseButton();
   void layoutSliderGroup(juce::Rectangle<int> bounds,
                          std::vector<juce::Slider *> sliders,
                          juce::Label &title);
@@ -47,25 +49,30 @@ private:
 
   // Sliders
   juce::Slider delayTime, delayFeedback, delayWidth, delayMix;
-  juce::Slider revSize, revDecay, revDamp, revMix;
-  juce::Slider biteDial;
+  juce::Slider revSize, revDecay, revDamp, revMix, convMix;
+  juce::Slider biteDial, biteSustain, biteLookahead;
 
   // Buttons
   juce::TextButton huntBtn, bitcrushBtn;
+  juce::TextButton delaySyncBtn, delayPingPongBtn;
+  juce::TextButton loadIrBtn; // Shows the loaded IR's name
 
   // Labels
   juce::Label delayTitle, reverbTitle, biteTitle, eqTitle;
   juce::Label dTimeLabel, dFdbkLabel, dWidthLabel, dMixLabel;
-  juce::Label rSizeLabel, rDecayLabel, rDampLabel, rMixLabel;
+  juce::Label rSizeLabel, rDecayLabel, rDampLabel, rMixLabel, convMixLabel;
+  juce::Label biteSustainLabel, biteLookaheadLabel;
 
   // Attachments
   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
-      dTimeAtt, dFdbkAtt, dMixAtt, // dWidthAtt? (Missing)
-      rSizeAtt, rDampAtt, rMixAtt, // rDecayAtt? (Missing)
-      biteAtt;
+      dTimeAtt, dFdbkAtt, dWidthAtt, dMixAtt,
+      rSizeAtt, rDecayAtt, rDampAtt, rMixAtt, convMixAtt,
+      biteAtt, biteSustainAtt, biteLookaheadAtt;
 
   std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> huntAtt,
-      bitcrushAtt;
+      bitcrushAtt, dSyncAtt, dPingPongAtt;
+
+  std::unique_ptr<juce::FileChooser> irChooser;
 
   // Missing param connections will be left null or unconnected visually
 
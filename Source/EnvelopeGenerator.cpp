@@ -0,0 +1,187 @@
+#include "EnvelopeGenerator.h"
+
+EnvelopeGenerator::EnvelopeGenerator() {
+  updateRates();
+  scratch.resize(512);
+}
+
+void EnvelopeGenerator::prepare(double newSampleRate, int samplesPerBlock) {
+  sampleRate = newSampleRate;
+  scratch.resize((size_t)juce::jmax(samplesPerBlock, 1));
+  updateRates();
+  reset();
+}
+
+void EnvelopeGenerator::setParameters(const Parameters &newParams) {
+  if (newParams == params)
+    return; // Called every block; only re-derive on a real change
+
+  params = newParams;
+  updateRates();
+
+  // Re-aim the running segment from where the level is now
+  if (stage == Stage::Sustain)
+    level = juce::jlimit(0.0f, 1.0f, params.sustain);
+  else if (stage != Stage::Idle)
+    enterStage(stage);
+}
+
+void EnvelopeGenerator::updateRates() {
+  // Large ratio = target far past the end point = nearly straight line.
+  // Small ratio = target just past it = strongly curved.
+  const float curve = juce::jlimit(0.0f, 1.0f, params.curve);
+  curveRatio = std::exp(juce::jmap((double)curve, std::log(100.0),
+                                   std::log(0.0005)));
+  // Attacks keep some overshoot so they stay convex rather than snapping up
+  attackRatio =
+      std::exp(juce::jmap((double)curve, std::log(100.0), std::log(0.3)));
+}
+
+void EnvelopeGenerator::noteOn() {
+  releaseOverride = -1.0f;
+  // Analog-style retrigger: the attack continues from the current level
+  enterStage(Stage::Attack);
+}
+
+void EnvelopeGenerator::noteOff() {
+  if (stage == Stage::Idle)
+    return;
+
+  releaseStart = level;
+  enterStage(Stage::Release);
+}
+
+void EnvelopeGenerator::forceRelease(float releaseSeconds) {
+  if (stage == Stage::Idle)
+    return;
+
+  releaseOverride = juce::jmax(0.0f, releaseSeconds);
+  releaseStart = level;
+  enterStage(Stage::Release);
+}
+
+void EnvelopeGenerator::reset() {
+  level = 0.0;
+  enterStage(Stage::Idle);
+}
+
+void EnvelopeGenerator::enterStage(Stage newStage) {
+  stage = newStage;
+
+  switch (stage) {
+  case Stage::Attack:
+    configureSegment(params.attack * sampleRate, 0.0, 1.0, attackRatio);
+    break;
+  case Stage::Decay:
+    configureSegment(params.decay * sampleRate, 1.0,
+                     juce::jlimit(0.0f, 1.0f, params.sustain), curveRatio);
+    break;
+  case Stage::Sustain:
+    level = juce::jlimit(0.0f, 1.0f, params.sustain);
+    samplesRemaining = held;
+    break;
+  case Stage::Release:
+    configureSegment((releaseOverride >= 0.0f ? releaseOverride
+                                              : params.release) *
+                         sampleRate,
+                     releaseStart, 0.0, curveRatio);
+    break;
+  case Stage::Idle:
+  default:
+    level = 0.0;
+    samplesRemaining = held;
+    break;
+  }
+}
+
+void EnvelopeGenerator::configureSegment(double lengthSamples, double from,
+                                         double to, double ratio) {
+  endLevel = to;
+  const double span = to - from;
+
+  if (lengthSamples < 1.0 || std::abs(span) < 1.0e-6) {
+    samplesRemaining = 0; // Instant stage
+    return;
+  }
+
+  // Aim past the end so the curve crosses it after exactly lengthSamples
+  // when starting from the nominal start level.
+  target = to + ratio * span;
+  coef = std::exp(-std::log((1.0 + ratio) / ratio) / lengthSamples);
+
+  // From the actual level (retrigger, parameter change mid-segment)
+  const double distance = (target - level) / (target - to);
+  if (distance <= 1.0)
+    samplesRemaining = 0; // Already at or past the end point
+  else
+    samplesRemaining = (int)juce::jmin(
+        (double)held, std::ceil(std::log(distance) / -std::log(coef)));
+
+  double p = 1.0;
+  powersExact[0] = 1.0;
+  for (int n = 0; n < chunkSize; ++n) {
+    p *= coef;
+    powers[(size_t)n] = (float)p;
+    powersExact[(size_t)n + 1] = p;
+  }
+}
+
+void EnvelopeGenerator::render(float *dest, int numSamples) {
+  int pos = 0;
+
+  while (pos < numSamples) {
+    if (isConstant()) {
+      juce::FloatVectorOperations::fill(dest + pos, (float)level,
+                                        numSamples - pos);
+      return;
+    }
+
+    if (samplesRemaining <= 0) {
+      level = endLevel;
+      switch (stage) {
+      case Stage::Attack:
+        enterStage(Stage::Decay);
+        break;
+      case Stage::Decay:
+        enterStage(Stage::Sustain);
+        break;
+      default:
+        enterStage(Stage::Idle);
+        break;
+      }
+      continue;
+    }
+
+    const int n = juce::jmin(numSamples - pos, samplesRemaining, chunkSize);
+    const double offset = level - target;
+
+    // level[k] = target + offset * coef^(k + 1)
+    juce::FloatVectorOperations::multiply(dest + pos, powers.data(),
+                                          (float)offset, n);
+    juce::FloatVectorOperations::add(dest + pos, (float)target, n);
+
+    // Carry the level in double so very long, nearly linear segments do not
+    // stall on float rounding
+    level = target + offset * powersExact[(size_t)n];
+    samplesRemaining -= n;
+    pos += n;
+  }
+}
+
+void EnvelopeGenerator::applyTo(float *data, int numSamples) {
+  if (isConstant()) {
+    if (level == 0.0)
+      juce::FloatVectorOperations::clear(data, numSamples);
+    else if (level != 1.0)
+      juce::FloatVectorOperations::multiply(data, (float)level, numSamples);
+    return;
+  }
+
+  int pos = 0;
+  while (pos < numSamples) {
+    const int n = juce::jmin(numSamples - pos, (int)scratch.size());
+    render(scratch.data(), n);
+    juce::FloatVectorOperations::multiply(data + pos, scratch.data(), n);
+    pos += n;
+  }
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <limits>
+
+//==============================================================================
+/**
+    Block-based ADSR used in place of juce::ADSR.
+
+    Every segment is a one-pole curve heading for a target slightly past its
+    end point, so the whole segment has a closed form:
+        level[n] = target + (start - target) * coef^n
+    A block is rendered from a small table of coef powers with two vector ops
+    per chunk instead of a per-sample state machine. The number of samples
+    left in the current stage is known up front, which lets the voice skip
+    work while the level is held (sustain).
+
+    The curve setting runs from 0 (effectively linear, like juce::ADSR) to 1
+    (analog-style exponential). noteOn() restarts the attack from the current
+    level instead of jumping to zero.
+*/
+class EnvelopeGenerator {
+public:
+  struct Parameters {
+    float attack = 0.1f;  // Seconds
+    float decay = 0.1f;   // Seconds
+    float sustain = 1.0f; // 0.0 - 1.0
+    float release = 0.1f; // Seconds
+    float curve = 0.0f;   // 0.0 = linear, 1.0 = exponential
+
+    bool operator==(const Parameters &other) const {
+      return attack == other.attack && decay == other.decay &&
+             sustain == other.sustain && release == other.release &&
+             curve == other.curve;
+    }
+    bool operator!=(const Parameters &other) const { return !(*this == other); }
+  };
+
+  enum class Stage { Idle, Attack, Decay, Sustain, Release };
+
+  EnvelopeGenerator();
+
+  void prepare(double newSampleRate, int samplesPerBlock);
+  void setParameters(const Parameters &newParams);
+
+  void noteOn();
+  void noteOff();
+  // Release over the given time instead of the release setting (drum chokes)
+  void forceRelease(float releaseSeconds);
+  void reset();
+
+  bool isActive() const { return stage != Stage::Idle; }
+  Stage getStage() const { return stage; }
+  float getCurrentLevel() const { return (float)level; }
+
+  // True while the level will not move until the next noteOn/noteOff
+  bool isConstant() const {
+    return stage == Stage::Sustain || stage == Stage::Idle;
+  }
+
+  // Samples left before the next stage change (max int while held)
+  int getSamplesUntilNextStage() const { return samplesRemaining; }
+
+  // Writes the envelope for the next numSamples into dest.
+  void render(float *dest, int numSamples);
+
+  // Multiplies data by the envelope (a single gain while it is held).
+  void applyTo(float *data, int numSamples);
+
+private:
+  static constexpr int chunkSize = 64;
+  static constexpr int held = std::numeric_limits<int>::max();
+
+  void updateRates();
+  void enterStage(Stage newStage);
+  void configureSegment(double lengthSamples, double from, double to,
+                        double ratio);
+
+  Parameters params;
+  double sampleRate = 44100.0;
+
+  Stage stage = Stage::Idle;
+  double level = 0.0;
+  double releaseStart = 0.0;
+  float releaseOverride = -1.0f; // Seconds, < 0 = use params.release
+
+  // Current segment
+  double target = 0.0;
+  double endLevel = 0.0;
+  double coef = 0.0;
+  int samplesRemaining = held;
+
+  // coef^(n + 1) for n = 0 .. chunkSize - 1, and coef^n in double precision
+  std::array<float, chunkSize> powers{};
+  std::array<double, chunkSize + 1> powersExact{};
+
+  // Overshoot ratios derived from the curve setting
+  double attackRatio = 100.0;
+  double curveRatio = 100.0;
+
+  std::vector<float> scratch;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EnvelopeGenerator)
+};
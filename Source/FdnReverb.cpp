@@ -0,0 +1,190 @@
+#include "FdnReverb.h"
+
+namespace {
+// Mutually prime base lengths (ms) at size 1.0
+constexpr std::array<float, 8> baseLengthsMs{29.7f, 37.1f, 41.1f, 43.7f,
+                                             53.9f, 59.3f, 67.1f, 73.3f};
+// Slightly different modulation rates so the lines never line up
+constexpr std::array<float, 8> modRatesHz{0.31f, 0.43f, 0.57f, 0.37f,
+                                          0.49f, 0.61f, 0.29f, 0.53f};
+} // namespace
+
+void FdnReverb::prepare(double newSampleRate, int maximumBlockSize) {
+  sampleRate = newSampleRate;
+
+  for (int l = 0; l < numLines; ++l) {
+    const double longest =
+        (baseLengthsMs[(size_t)l] * maxSizeScale + modDepthMs) * 0.001 *
+        sampleRate;
+    const auto size =
+        juce::nextPowerOfTwo((int)std::ceil(longest) + maximumBlockSize + 4);
+    lines[(size_t)l].assign((size_t)size, 0.0f);
+    masks[(size_t)l] = (unsigned int)size - 1;
+  }
+
+  // Left feeds / is read from the even lines, right the odd ones, with
+  // alternating signs so the two sides decorrelate
+  for (int r = 0; r < numRegisters; ++r) {
+    for (int lane = 0; lane < lanes; ++lane) {
+      const int l = r * lanes + lane;
+      const float sign = (l / 2) % 2 == 0 ? 1.0f : -1.0f;
+      const bool isLeft = l % 2 == 0;
+      inputGainL[(size_t)r].set((size_t)lane, isLeft ? 0.5f * sign : 0.0f);
+      inputGainR[(size_t)r].set((size_t)lane, isLeft ? 0.0f : 0.5f * sign);
+      outputGainL[(size_t)r].set((size_t)lane, isLeft ? 0.5f * sign : 0.0f);
+      outputGainR[(size_t)r].set((size_t)lane, isLeft ? 0.0f : 0.5f * sign);
+    }
+  }
+
+  reset();
+}
+
+void FdnReverb::reset() {
+  for (auto &line : lines)
+    std::fill(line.begin(), line.end(), 0.0f);
+  for (auto &state : lowState)
+    state = Vec::expand(0.0f);
+  writePos = 0;
+  modPhases = {};
+  delaysValid = false;
+}
+
+float FdnReverb::getDecaySeconds() const {
+  return 0.3f * std::pow(40.0f, juce::jlimit(0.0f, 1.0f, params.decay));
+}
+
+float FdnReverb::getTailSeconds() const {
+  if (params.mix < 1.0e-4f)
+    return 0.0f;
+  return getDecaySeconds() + baseLengthsMs.back() * maxSizeScale * 0.001f;
+}
+
+void FdnReverb::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  if (numSamples == 0 || buffer.getNumChannels() == 0 || lines[0].empty())
+    return;
+
+  // Mix: one smoothing step per block, ramped across it
+  const float coeff = 1.0f - (float)std::exp(-(double)numSamples /
+                                             (smoothingSeconds * sampleRate));
+  const float mixStart = mix;
+  mix += (params.mix - mix) * coeff;
+
+  if (mixStart < 1.0e-4f && mix < 1.0e-4f) {
+    idle = true;
+    return;
+  }
+  if (idle) {
+    reset(); // Start from silence, not a stale tail
+    idle = false;
+  }
+
+  // --- Block-rate control ---
+  const float sizeScale =
+      juce::jmap(juce::jlimit(0.0f, 1.0f, params.size), minSizeScale,
+                 maxSizeScale);
+  const float rt60 = getDecaySeconds();
+  const float depth = modDepthMs * 0.001f * (float)sampleRate;
+  const float blockSeconds = (float)numSamples / (float)sampleRate;
+
+  std::array<float, numLines> delayStart{}, delayStep{};
+  alignas(32) std::array<float, numLines> gains{};
+
+  for (int l = 0; l < numLines; ++l) {
+    auto &phase = modPhases[(size_t)l];
+    phase += juce::MathConstants<float>::twoPi * modRatesHz[(size_t)l] *
+             blockSeconds;
+    if (phase > juce::MathConstants<float>::twoPi)
+      phase -= juce::MathConstants<float>::twoPi;
+
+    const float length =
+        baseLengthsMs[(size_t)l] * sizeScale * 0.001f * (float)sampleRate;
+    const float target = length + depth * (1.0f + std::sin(phase));
+
+    const float start = delaysValid ? delays[(size_t)l] : target;
+    delayStart[(size_t)l] = start;
+    delayStep[(size_t)l] = (target - start) / (float)numSamples;
+    delays[(size_t)l] = target;
+
+    // -60 dB after rt60 seconds: g = 10^(-3 * length / (rt60 * rate))
+    gains[(size_t)l] =
+        std::pow(10.0f, -3.0f * length / (rt60 * (float)sampleRate));
+  }
+  delaysValid = true;
+
+  std::array<Vec, numRegisters> gainVec;
+  for (int r = 0; r < numRegisters; ++r)
+    gainVec[(size_t)r] = Vec::fromRawArray(gains.data() + r * lanes);
+
+  // Damping 0 - 1 maps to an 18 kHz - 1.5 kHz one-pole in the loop
+  const float dampCutoff =
+      18000.0f * std::pow(1500.0f / 18000.0f,
+                          juce::jlimit(0.0f, 1.0f, params.damping));
+  const float dampCoeff =
+      1.0f - std::exp(-juce::MathConstants<float>::twoPi *
+                      juce::jmin(dampCutoff, 0.45f * (float)sampleRate) /
+                      (float)sampleRate);
+
+  const float mixStep = (mix - mixStart) / (float)numSamples;
+  const float sideGain = 0.5f * params.width;
+  constexpr float householder = 2.0f / (float)numLines;
+
+  auto *left = buffer.getWritePointer(0);
+  auto *right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1)
+                                            : nullptr;
+
+  // --- Per sample ---
+  alignas(32) std::array<float, numLines> taps{};
+  std::array<Vec, numRegisters> v;
+
+  for (int i = 0; i < numSamples; ++i) {
+    // 1. Interpolated reads
+    for (int l = 0; l < numLines; ++l) {
+      const float d = delayStart[(size_t)l] + delayStep[(size_t)l] * (float)i;
+      const auto whole = (unsigned int)d;
+      const float frac = d - (float)whole;
+      const auto &line = lines[(size_t)l];
+      const auto mask = masks[(size_t)l];
+      const float newer = line[(writePos - whole) & mask];
+      const float older = line[(writePos - whole - 1) & mask];
+      taps[(size_t)l] = newer + frac * (older - newer);
+    }
+
+    const float inL = left[i];
+    const float inR = right != nullptr ? right[i] : inL;
+
+    // 2. Damping, output taps, decay, Householder mix, input (SIMD)
+    float wetL = 0.0f, wetR = 0.0f, sum = 0.0f;
+    for (int r = 0; r < numRegisters; ++r) {
+      auto &low = lowState[(size_t)r];
+      low += (Vec::fromRawArray(taps.data() + r * lanes) - low) * dampCoeff;
+
+      wetL += (low * outputGainL[(size_t)r]).sum();
+      wetR += (low * outputGainR[(size_t)r]).sum();
+
+      v[(size_t)r] = low * gainVec[(size_t)r];
+      sum += v[(size_t)r].sum();
+    }
+
+    const float reflection = sum * householder;
+    for (int r = 0; r < numRegisters; ++r) {
+      v[(size_t)r] = v[(size_t)r] - reflection +
+                     inputGainL[(size_t)r] * inL + inputGainR[(size_t)r] * inR;
+      v[(size_t)r].copyToRawArray(taps.data() + r * lanes);
+    }
+
+    // 3. Writes
+    for (int l = 0; l < numLines; ++l)
+      lines[(size_t)l][writePos & masks[(size_t)l]] = taps[(size_t)l];
+    ++writePos;
+
+    // 4. Width and mix (same dry/wet balance as the old Freeverb stage)
+    const float mid = 0.5f * (wetL + wetR);
+    const float side = (wetL - wetR) * sideGain;
+    const float m = mixStart + mixStep * (float)(i + 1);
+
+    left[i] = inL * (1.0f - m) + (mid + side) * m;
+    if (right != nullptr)
+      right[i] = inR * (1.0f - m) + (mid - side) * m;
+  }
+}
@@ -22,68 +22,151 @@ const float formantGains[5][5] = {
 
 FilterProcessor::FilterProcessor() {
   filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-  // Default formant init
-  updateFormantCoefficients();
 }
 
 void FilterProcessor::prepare(const juce::dsp::ProcessSpec &spec) {
   sampleRate = (float)spec.sampleRate;
   filter.prepare(spec);
-  filter.reset();
 
-  // Prepare formant bands
-  for (auto &band : formantBands) {
-    band.filter.prepare(spec);
-    band.filter.reset();
-  }
+  vowelCoeff = 1.0f - (float)std::exp(-(double)controlInterval /
+                                      (vowelGlideSeconds * spec.sampleRate));
+  reset();
 }
 
 void FilterProcessor::process(juce::AudioBuffer<float> &buffer) {
   if (currentType == Formant) {
-    // Parallel implementation
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
+    processFormants(buffer);
+  } else if (currentType == Notch) {
+    processNotch(buffer);
+  } else {
+    juce::dsp::AudioBlock<float> block(buffer);
+    juce::dsp::ProcessContextReplacing<float> context(block);
+    filter.process(context);
+  }
+}
+
+void FilterProcessor::processNotch(juce::AudioBuffer<float> &buffer) {
+  // The TPT band-pass peaks at q (its R2 is 1 / q): the input minus the
+  // band-pass scaled back to unity gain cancels the band exactly
+  const float scale = 1.0f / filterQ;
+  const int numSamples = buffer.getNumSamples();
+  for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+    auto *data = buffer.getWritePointer(ch);
+    for (int i = 0; i < numSamples; ++i)
+      data[i] -= filter.processSample(ch, data[i]) * scale;
+  }
+  filter.snapToZero();
+}
+
+void FilterProcessor::processFormants(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int channels = juce::jmin(buffer.getNumChannels(), maxChannels);
+  if (numSamples == 0 || channels == 0)
+    return;
+
+  std::array<float *, maxChannels> data{};
+  for (int ch = 0; ch < channels; ++ch)
+    data[(size_t)ch] = buffer.getWritePointer(ch);
 
-    // We need a scratch buffer to sum into, because we can't process in-place
-    // effectively in parallel logic without copying the input first. Easiest:
-    // Copy input to scratch, clear output, add formatted bands to output.
+  Coefficients target, step;
 
-    juce::AudioBuffer<float> scratchBuffer;
-    scratchBuffer.makeCopyOf(buffer);
-    buffer.clear();
+  for (int start = 0; start < numSamples; start += controlInterval) {
+    const int count = juce::jmin(controlInterval, numSamples - start);
 
-    for (int i = 0; i < 5; ++i) {
-      // Create a temp copy for this band processing
-      juce::AudioBuffer<float> bandBuffer;
-      bandBuffer.makeCopyOf(scratchBuffer);
+    // 1. Control rate: glide the vowel and ramp to its coefficients
+    vowel += (vowelTarget - vowel) * vowelCoeff;
+    computeFormantCoefficients(target);
+    if (!coeffsValid) {
+      coeffs = target;
+      coeffsValid = true;
+    }
 
-      juce::dsp::AudioBlock<float> block(bandBuffer);
-      juce::dsp::ProcessContextReplacing<float> context(block);
-      formantBands[i].filter.process(context);
+    const float scale = 1.0f / (float)count;
+    for (int r = 0; r < numRegisters; ++r) {
+      const auto reg = (size_t)r;
+      step.b0[reg] = (target.b0[reg] - coeffs.b0[reg]) * scale;
+      step.a1[reg] = (target.a1[reg] - coeffs.a1[reg]) * scale;
+      step.a2[reg] = (target.a2[reg] - coeffs.a2[reg]) * scale;
+    }
 
-      // Apply Gain
-      bandBuffer.applyGain(formantBands[i].targetGain);
+    // 2. Per sample: every band of a channel in one pass (TDF-II)
+    for (int i = start; i < start + count; ++i) {
+      for (int r = 0; r < numRegisters; ++r) {
+        coeffs.b0[(size_t)r] += step.b0[(size_t)r];
+        coeffs.a1[(size_t)r] += step.a1[(size_t)r];
+        coeffs.a2[(size_t)r] += step.a2[(size_t)r];
+      }
 
-      // Sum into main buffer
-      for (int ch = 0; ch < numChannels; ++ch) {
-        buffer.addFrom(ch, 0, bandBuffer, ch, 0, numSamples);
+      for (int ch = 0; ch < channels; ++ch) {
+        auto &s1 = state1[(size_t)ch];
+        auto &s2 = state2[(size_t)ch];
+        const float x = data[(size_t)ch][i];
+
+        float out = 0.0f;
+        for (int r = 0; r < numRegisters; ++r) {
+          const auto bx = coeffs.b0[(size_t)r] * x;
+          const auto y = bx + s1[(size_t)r];
+          s1[(size_t)r] = s2[(size_t)r] - coeffs.a1[(size_t)r] * y;
+          s2[(size_t)r] = (bx + coeffs.a2[(size_t)r] * y) * -1.0f;
+          out += y.sum();
+        }
+        data[(size_t)ch][i] = out;
       }
     }
 
-  } else {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    filter.process(context);
+    // Land exactly on the target (no drift from the additions)
+    coeffs = target;
+  }
+}
+
+void FilterProcessor::computeFormantCoefficients(Coefficients &target) const {
+  // Interpolate between vowels
+  // 0 = A, 1 = E, 2 = I, 3 = O, 4 = U
+  const int index1 = juce::jlimit(0, 4, (int)vowel);
+  const int index2 = std::min(index1 + 1, 4);
+  const float alpha = vowel - (float)index1;
+
+  alignas(32) std::array<float, numLanes> b0{}, a1{}, a2{};
+  for (int i = 0; i < numBands; ++i) {
+    float f1 = formantFreqs[index1][i];
+    float f2 = formantFreqs[index2][i];
+    float freq = juce::jmin(f1 + (f2 - f1) * alpha, 0.45f * sampleRate);
+
+    float g1 = formantGains[index1][i];
+    float g2 = formantGains[index2][i];
+    float gain = g1 + (g2 - g1) * alpha;
+
+    // RBJ band-pass (0 dB peak), normalised by a0, band gain folded into b
+    const float w0 = juce::MathConstants<float>::twoPi * freq / sampleRate;
+    const float bw = std::sin(w0) / (2.0f * formantQ);
+    const float a0 = 1.0f / (1.0f + bw);
+    b0[(size_t)i] = bw * a0 * gain;
+    a1[(size_t)i] = -2.0f * std::cos(w0) * a0;
+    a2[(size_t)i] = (1.0f - bw) * a0;
+  }
+
+  // Padding lanes stay at zero: no output, no state
+  for (int r = 0; r < numRegisters; ++r) {
+    target.b0[(size_t)r] = Vec::fromRawArray(b0.data() + r * lanes);
+    target.a1[(size_t)r] = Vec::fromRawArray(a1.data() + r * lanes);
+    target.a2[(size_t)r] = Vec::fromRawArray(a2.data() + r * lanes);
   }
 }
 
 void FilterProcessor::reset() {
   filter.reset();
-  for (auto &band : formantBands)
-    band.filter.reset();
+  for (auto &channel : state1)
+    channel.fill(Vec::expand(0.0f));
+  for (auto &channel : state2)
+    channel.fill(Vec::expand(0.0f));
+  vowel = vowelTarget;
+  coeffsValid = false;
 }
 
 void FilterProcessor::setFilterType(FilterType type) {
+  if (type == Formant && currentType != Formant)
+    reset(); // Bank state is stale after running the SVF
+
   currentType = type;
 
   switch (type) {
@@ -96,61 +179,28 @@ void FilterProcessor::setFilterType(FilterType type) {
   case BandPass:
     filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
     break;
-  case Notch:
+  case Notch: // Band-pass, subtracted from the input in processNotch
     filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
     break;
   case Formant:
-    updateFormantCoefficients();
     break;
   }
 }
 
 void FilterProcessor::setCutoff(float cutoffHz) {
-  filter.setCutoffFrequency(cutoffHz);
+  filter.setCutoffFrequency(
+      juce::jlimit(20.0f, 0.45f * sampleRate, cutoffHz));
 }
 
 void FilterProcessor::setResonance(float resonance) {
   float q = 0.5f + resonance * 9.5f;
   filter.setResonance(q);
+  filterQ = q;
 
-  // Also update formant Q if we want global Q control
-  // For formants, usually Q is fixed or high, but let's allow "singing" vs
-  // "mumbling"
-  for (auto &band : formantBands) {
-    band.targetQ = q * 2.0f; // Formants usually fairly resonant
-  }
-  updateFormantCoefficients();
+  // Formants usually fairly resonant; picked up at the next control step
+  formantQ = q * 2.0f;
 }
 
 void FilterProcessor::setVowel(float vowelPos) {
-  if (std::abs(vowelPosition - vowelPos) > 0.001f) {
-    vowelPosition =
-        juce::jlimit(0.0f, 4.0f, vowelPos * 4.0f); // Map 0-1 to 0-4 range
-    updateFormantCoefficients();
-  }
-}
-
-void FilterProcessor::updateFormantCoefficients() {
-  // Interpolate between vowels
-  // 0 = A, 1 = E, 2 = I, 3 = O, 4 = U
-
-  int index1 = (int)vowelPosition;
-  int index2 = std::min(index1 + 1, 4);
-  float alpha = vowelPosition - (float)index1;
-
-  for (int i = 0; i < 5; ++i) {
-    float f1 = formantFreqs[index1][i];
-    float f2 = formantFreqs[index2][i];
-    float freq = f1 + (f2 - f1) * alpha;
-
-    float g1 = formantGains[index1][i];
-    float g2 = formantGains[index2][i];
-    float gain = g1 + (g2 - g1) * alpha;
-
-    // Update filters
-    formantBands[i].filter.coefficients =
-        juce::dsp::IIR::Coefficients<float>::makeBandPass(
-            sampleRate, freq, formantBands[i].targetQ);
-    formantBands[i].targetGain = gain;
-  }
+  vowelTarget = juce::jlimit(0.0f, 1.0f, vowelPos) * 4.0f; // 0-1 to 0-4
 }
@@ -1,6 +1,24 @@
 #pragma once
 #include <JuceHeader.h>
+#include <array>
 
+//==============================================================================
+/**
+    Global filter after the synth: a TPT state-variable filter for the
+    classic types (the notch is the input minus its normalised band-pass),
+    or five vowel formants.
+
+    The formants run as one bank of band-pass biquads on SIMD registers (the
+    five bands padded to a whole number of registers), so every input sample
+    is read once and each band costs one lane instead of its own pass over a
+    copy of the block. The band gains are folded into the coefficients.
+
+    Coefficients are worked out at control rate (every controlInterval
+    samples) from the gliding vowel position and interpolated linearly
+    across each interval. A mix of two stable band-pass sets is itself
+    stable, so vowel sweeps and LFO modulation stay smooth without
+    recomputing trig per sample. Nothing allocates after prepare.
+*/
 class FilterProcessor {
 public:
   FilterProcessor();
@@ -17,20 +35,36 @@ public:
   void setVowel(float vowelPos); // 0.0 (A) to 1.0 (U)
 
 private:
-  struct FormantBand {
-    juce::dsp::IIR::Filter<float> filter;
-    float targetFreq = 1000.0f;
-    float targetQ = 1.0f;
-    float targetGain = 1.0f;
+  using Vec = juce::dsp::SIMDRegister<float>;
+  static constexpr int numBands = 5;
+  static constexpr int lanes = (int)Vec::SIMDNumElements;
+  static constexpr int numRegisters = (numBands + lanes - 1) / lanes;
+  static constexpr int numLanes = numRegisters * lanes;
+  static constexpr int maxChannels = 2;
+  static constexpr int controlInterval = 32;
+  static constexpr double vowelGlideSeconds = 0.02;
+
+  // Band-pass with 0 dB peak: b1 = 0 and b2 = -b0, so three terms per lane
+  struct Coefficients {
+    std::array<Vec, numRegisters> b0{}, a1{}, a2{};
   };
 
-  // 5 parallel bands for formants
-  std::array<FormantBand, 5> formantBands;
-  void updateFormantCoefficients();
+  void processNotch(juce::AudioBuffer<float> &buffer);
+  void processFormants(juce::AudioBuffer<float> &buffer);
+  // Coefficients for the current vowel and Q (control rate)
+  void computeFormantCoefficients(Coefficients &target) const;
+
+  // Formant bank
+  Coefficients coeffs;
+  bool coeffsValid = false;
+  std::array<std::array<Vec, numRegisters>, maxChannels> state1{}, state2{};
+  float vowelTarget = 0.0f, vowel = 0.0f; // 0.0 - 4.0 (A - U)
+  float vowelCoeff = 1.0f;                // Glide per control interval
+  float formantQ = 8.0f;
 
-  float vowelPosition = 0.0f; // 0.0 - 1.0
   juce::dsp::StateVariableTPTFilter<float> filter;
   FilterType currentType = LowPass;
+  float filterQ = 0.5f; // SVF resonance, for the notch
   float sampleRate = 44100.0f;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FilterProcessor)
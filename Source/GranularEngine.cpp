@@ -0,0 +1,156 @@
+#include "GranularEngine.h"
+
+GranularEngine::GranularEngine() { reset(); }
+
+const std::array<float, GranularEngine::windowSize + 1> &
+GranularEngine::getWindowTable() {
+  // Hann window, shared by every voice. One extra point so the interpolated
+  // lookup never needs a bounds check.
+  static const auto table = [] {
+    std::array<float, windowSize + 1> t{};
+    for (int i = 0; i <= windowSize; ++i)
+      t[(size_t)i] =
+          0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float)i /
+                                 (float)windowSize);
+    return t;
+  }();
+  return table;
+}
+
+void GranularEngine::prepare(double newSampleRate, int samplesPerBlock) {
+  sampleRate = newSampleRate;
+  grainBuffer.assign((size_t)juce::jmax(1, samplesPerBlock), 0.0f);
+  getWindowTable(); // Build the table here rather than on the audio thread
+  reset();
+}
+
+void GranularEngine::reset() {
+  for (int i = 0; i < maxGrains; ++i)
+    freeList[(size_t)i] = i;
+  numFree = maxGrains;
+  numActive = 0;
+  samplesToNextGrain = 0.0;
+}
+
+void GranularEngine::start(const juce::AudioBuffer<float> &source,
+                           int length, double pitchRatio) {
+  reset();
+
+  sourceL = source.getReadPointer(0);
+  sourceR = source.getNumChannels() > 1 ? source.getReadPointer(1) : nullptr;
+  sourceLength = juce::jmin(length, source.getNumSamples() - 1);
+  notePitchRatio = pitchRatio;
+  bendRatio = 1.0;
+}
+
+void GranularEngine::spawnGrain(int startDelay) {
+  if (numFree == 0 || sourceLength < 2)
+    return; // Pool exhausted: skip this onset rather than steal
+
+  const int index = freeList[(size_t)--numFree];
+  auto &grain = grains[(size_t)index];
+
+  const double increment =
+      notePitchRatio * bendRatio * std::pow(2.0, (double)params.pitch / 12.0);
+  int length = juce::jmax(
+      16, juce::roundToInt(params.sizeMs * 0.001 * sampleRate));
+
+  // Keep the whole grain inside the sample
+  const double maxSpan = (double)(sourceLength - 2);
+  if ((double)length * increment > maxSpan)
+    length = juce::jmax(1, (int)(maxSpan / increment));
+  const double span = (double)length * increment;
+
+  const double centre = (double)params.position * (double)sourceLength;
+  const double offset = ((double)random.nextFloat() * 2.0 - 1.0) *
+                        (double)params.spray * 0.5 * (double)sourceLength;
+
+  grain.position = juce::jlimit(0.0, juce::jmax(0.0, maxSpan - span),
+                                centre + offset - span * 0.5);
+  grain.increment = increment;
+  grain.windowPhase = 0.0f;
+  grain.windowIncrement = (float)windowSize / (float)length;
+  grain.samplesRemaining = length;
+  grain.startDelay = startDelay;
+
+  // Overlapping grains sum roughly as uncorrelated noise
+  const float overlap = params.density * params.sizeMs * 0.001f;
+  grain.gain = 1.0f / std::sqrt(juce::jmax(1.0f, overlap * 0.5f));
+
+  activeList[(size_t)numActive++] = index;
+}
+
+void GranularEngine::renderGrain(Grain &grain, float *dest, int numSamples) {
+  const int start = grain.startDelay;
+  const int count = juce::jmin(numSamples - start, grain.samplesRemaining);
+  grain.startDelay = 0;
+
+  if (count <= 0)
+    return;
+
+  const auto &window = getWindowTable();
+  auto *scratch = grainBuffer.data();
+
+  double pos = grain.position;
+  float phase = grain.windowPhase;
+
+  for (int i = 0; i < count; ++i) {
+    const int idx = (int)pos;
+    const float frac = (float)(pos - (double)idx);
+
+    float s = sourceL[idx] + frac * (sourceL[idx + 1] - sourceL[idx]);
+    if (sourceR != nullptr)
+      s = 0.5f * (s + sourceR[idx] + frac * (sourceR[idx + 1] - sourceR[idx]));
+
+    const int w = juce::jmin((int)phase, windowSize - 1);
+    const float wFrac = phase - (float)w;
+    const float win = window[(size_t)w] +
+                      wFrac * (window[(size_t)w + 1] - window[(size_t)w]);
+
+    scratch[i] = s * win;
+
+    pos += grain.increment;
+    phase += grain.windowIncrement;
+  }
+
+  grain.position = pos;
+  grain.windowPhase = phase;
+  grain.samplesRemaining -= count;
+
+  // Mixing into the voice buffer is the vectorised part
+  juce::FloatVectorOperations::addWithMultiply(dest + start, scratch,
+                                               grain.gain, count);
+}
+
+void GranularEngine::render(float *dest, int numSamples) {
+  if (sourceL == nullptr)
+    return;
+
+  if ((int)grainBuffer.size() < numSamples)
+    return; // Not prepared for this block size
+
+  // 1. Schedule onsets that fall inside this block
+  const double interval =
+      sampleRate / (double)juce::jmax(0.1f, params.density);
+
+  while (samplesToNextGrain < (double)numSamples) {
+    spawnGrain((int)samplesToNextGrain);
+    samplesToNextGrain += interval;
+  }
+  samplesToNextGrain -= (double)numSamples;
+
+  // 2. Render and retire
+  for (int i = 0; i < numActive;) {
+    const int index = activeList[(size_t)i];
+    auto &grain = grains[(size_t)index];
+
+    renderGrain(grain, dest, numSamples);
+
+    if (grain.samplesRemaining <= 0) {
+      freeList[(size_t)numFree++] = index;
+      activeList[(size_t)i] = activeList[(size_t)--numActive];
+    } else {
+      ++i;
+    }
+  }
+}
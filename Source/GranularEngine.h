@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/**
+    Granular playback for a single HowlingVoice.
+
+    Reads short Hann-windowed grains out of a loaded sample buffer. Grains are
+    taken from a fixed pool (no allocation on the audio thread) and their
+    onsets are scheduled to the exact sample inside the block, so density
+    changes do not jitter with the host buffer size.
+*/
+class GranularEngine {
+public:
+  static constexpr int maxGrains = 128;
+
+  struct Parameters {
+    float position = 0.5f; // 0.0 - 1.0 of the sample length
+    float spray = 0.1f;    // 0.0 - 1.0 random position offset
+    float sizeMs = 80.0f;  // Grain length
+    float density = 40.0f; // Grains per second
+    float pitch = 0.0f;    // Semitones on top of the played note
+  };
+
+  GranularEngine();
+
+  void prepare(double sampleRate, int samplesPerBlock);
+  void reset();
+
+  void setParameters(const Parameters &newParams) { params = newParams; }
+
+  // Starts a new cloud on the given sample data. pitchRatio already includes
+  // the note transposition and the source/host sample rate ratio.
+  void start(const juce::AudioBuffer<float> &source, int sourceLength,
+             double pitchRatio);
+
+  // Extra pitch ratio on top of the note (MPE bend). Applies to new grains.
+  void setBendRatio(double ratio) { bendRatio = ratio; }
+
+  // Adds the (mono) cloud output to dest.
+  void render(float *dest, int numSamples);
+
+  int getNumActiveGrains() const { return numActive; }
+
+private:
+  struct Grain {
+    double position = 0.0;  // Read position in source samples
+    double increment = 1.0; // Source samples per output sample
+    float windowPhase = 0.0f;
+    float windowIncrement = 0.0f;
+    int samplesRemaining = 0;
+    int startDelay = 0; // Sample offset of the onset inside the next block
+    float gain = 1.0f;
+  };
+
+  void spawnGrain(int startDelay);
+  void renderGrain(Grain &grain, float *dest, int numSamples);
+
+  static constexpr int windowSize = 1024;
+  static const std::array<float, windowSize + 1> &getWindowTable();
+
+  std::array<Grain, maxGrains> grains;
+  std::array<int, maxGrains> freeList;   // Indices of unused grains
+  std::array<int, maxGrains> activeList; // Indices of playing grains
+  int numFree = maxGrains;
+  int numActive = 0;
+
+  std::vector<float> grainBuffer; // Scratch for one grain, one block long
+
+  Parameters params;
+  juce::Random random;
+
+  const float *sourceL = nullptr;
+  const float *sourceR = nullptr;
+  int sourceLength = 0;
+  double notePitchRatio = 1.0;
+  double bendRatio = 1.0;
+
+  double sampleRate = 44100.0;
+  double samplesToNextGrain = 0.0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GranularEngine)
+};
@@ -10,33 +10,40 @@ void LFOProcessor::prepare(double sampleRate) {
 
 void LFOProcessor::reset() { phase = 0.0; }
 
-float LFOProcessor::getNextSample() {
+float LFOProcessor::getNextSample() { return advance(1); }
+
+float LFOProcessor::advance(int numSamples) {
+  const float output = getValueAt(phase);
+
+  // Advance phase
+  phase += phaseIncrement * numSamples;
+  phase -= std::floor(phase);
+
+  // Apply depth (0.0 to 1.0 range)
+  return output * currentDepth;
+}
+
+float LFOProcessor::getValueAt(double position) const {
   float output = 0.0f;
 
   switch (currentWaveform) {
   case Sine:
-    output = std::sin(phase * juce::MathConstants<double>::twoPi);
+    output = std::sin(position * juce::MathConstants<double>::twoPi);
     break;
 
   case Square:
-    output = (phase < 0.5) ? 1.0f : -1.0f;
+    output = (position < 0.5) ? 1.0f : -1.0f;
     break;
 
   case Triangle:
-    if (phase < 0.5)
-      output = -1.0f + 4.0f * phase;
+    if (position < 0.5)
+      output = -1.0f + 4.0f * position;
     else
-      output = 3.0f - 4.0f * phase;
+      output = 3.0f - 4.0f * position;
     break;
   }
 
-  // Advance phase
-  phase += phaseIncrement;
-  if (phase >= 1.0)
-    phase -= 1.0;
-
-  // Apply depth (0.0 to 1.0 range)
-  return output * currentDepth;
+  return output;
 }
 
 void LFOProcessor::setWaveform(Waveform wave) { currentWaveform = wave; }
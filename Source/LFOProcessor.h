@@ -12,6 +12,8 @@ public:
   void prepare(double sampleRate);
   void reset();
   float getNextSample();
+  // Control rate: the value now, then skips ahead numSamples samples
+  float advance(int numSamples);
 
   void setWaveform(Waveform wave);
   void setRate(float rateHz);
@@ -22,6 +24,8 @@ public:
   float getDepth() const { return currentDepth; }
 
 private:
+  float getValueAt(double position) const;
+
   Waveform currentWaveform = Sine;
   Target currentTarget = FilterCutoff;
   float currentRate = 1.0f;
@@ -0,0 +1,270 @@
+#include "PatchFreezer.h"
+
+namespace {
+// Lets HowlingSound (which loads through an AudioFormatReader) take its data
+// from a rendered buffer.
+class BufferAudioFormatReader : public juce::AudioFormatReader {
+public:
+  BufferAudioFormatReader(const juce::AudioBuffer<float> &source, int length,
+                          double rate)
+      : juce::AudioFormatReader(nullptr, "Frozen Patch"), buffer(source) {
+    sampleRate = rate;
+    bitsPerSample = 32;
+    lengthInSamples = juce::jmin(length, source.getNumSamples());
+    numChannels = (unsigned int)source.getNumChannels();
+    usesFloatingPointData = true;
+  }
+
+  bool readSamples(int *const *destChannels, int numDestChannels,
+                   int startOffsetInDestBuffer, juce::int64 startSampleInFile,
+                   int numSamples) override {
+    const int available = (int)juce::jlimit(
+        (juce::int64)0, (juce::int64)numSamples,
+        lengthInSamples - startSampleInFile);
+
+    for (int ch = 0; ch < numDestChannels; ++ch) {
+      if (destChannels[ch] == nullptr)
+        continue;
+
+      auto *dest =
+          reinterpret_cast<float *>(destChannels[ch]) + startOffsetInDestBuffer;
+
+      if (ch < (int)numChannels && available > 0)
+        juce::FloatVectorOperations::copy(
+            dest, buffer.getReadPointer(ch, (int)startSampleInFile),
+            available);
+
+      const int filled = ch < (int)numChannels ? available : 0;
+      juce::FloatVectorOperations::clear(dest + filled, numSamples - filled);
+    }
+
+    return true;
+  }
+
+private:
+  const juce::AudioBuffer<float> &buffer;
+};
+} // namespace
+
+//==============================================================================
+void PatchFreezer::Patch::applyTo(SynthEngine &engine) const {
+  engine.updateParams(attack, decay, sustain, release, cutoff, resonance,
+                      filterType, lfoRate, lfoDepth);
+  engine.updateModParams(modAttack, modDecay, modSustain, modRelease,
+                         modAmount, modTarget);
+  engine.updateSampleParams(tune, sampleStart, sampleEnd, loop);
+  engine.updateFilterDrive(filterDrive, filterQuality);
+  engine.setEnvelopeCurve(envCurve);
+}
+
+//==============================================================================
+PatchFreezer::PatchFreezer()
+    : pool(juce::ThreadPoolOptions{}
+               .withThreadName("Patch Freeze")
+               .withNumberOfThreads(juce::jlimit(
+                   1, 4, juce::SystemStats::getNumCpus() - 1))) {}
+
+PatchFreezer::~PatchFreezer() {
+  cancelled = true;
+  pool.removeAllJobs(true, 10000);
+  cancelPendingUpdate();
+}
+
+void PatchFreezer::cancel() { cancelled = true; }
+
+float PatchFreezer::getProgress() const {
+  const int total = totalZones.load();
+  return total > 0 ? 1.0f - (float)pendingZones.load() / (float)total : 0.0f;
+}
+
+bool PatchFreezer::freeze(
+    const juce::ReferenceCountedArray<HowlingSound> &sources,
+    const Patch &patch, const Settings &settings, double sampleRate) {
+  if (sampleRate <= 0.0 || isFreezing())
+    return false;
+
+  const int low = juce::jlimit(0, 127, settings.lowNote);
+  const int high = juce::jlimit(low, 127, settings.highNote);
+  const int step = juce::jmax(1, settings.noteStep);
+  const int layers = juce::jlimit(1, 8, settings.velocityLayers);
+
+  // 1. Zones: each source over the keys it plays inside the range
+  std::vector<Zone> zones;
+  for (int i = 0; i < sources.size(); ++i) {
+    auto *source = sources.getUnchecked(i);
+    if (source == nullptr || source->getAudioData() == nullptr)
+      continue;
+
+    int first = -1, last = -1;
+    for (int note = low; note <= high; ++note) {
+      if (source->appliesToNote(note)) {
+        first = first < 0 ? note : first;
+        last = note;
+      }
+    }
+    if (first < 0)
+      continue;
+
+    // Pads keep one layer: note-on picks a pad by note, not by velocity
+    addZones(zones, i, first, last, step,
+             source->hasPadSettings() ? 1 : layers);
+  }
+
+  if (zones.empty())
+    return false;
+
+  {
+    const juce::ScopedLock sl(resultLock);
+    results.clear();
+    frozenSources = sources;
+  }
+
+  cancelled = false;
+  totalZones = (int)zones.size();
+  pendingZones = (int)zones.size();
+
+  for (const auto &zone : zones) {
+    // Hold a reference so the sound outlives the jobs even if it is replaced
+    juce::ReferenceCountedObjectPtr<HowlingSound> sourcePtr(
+        sources.getUnchecked(zone.source));
+
+    pool.addJob([this, sourcePtr, patch, settings, zone, sampleRate] {
+      if (!cancelled) {
+        juce::ReferenceCountedObjectPtr<HowlingSound> sound(renderZone(
+            *sourcePtr, patch, settings, zone, sampleRate, cancelled));
+
+        if (sound != nullptr) {
+          const juce::ScopedLock sl(resultLock);
+          results.add(sound);
+        }
+      }
+
+      if (--pendingZones == 0)
+        triggerAsyncUpdate();
+    });
+  }
+
+  return true;
+}
+
+void PatchFreezer::addZones(std::vector<Zone> &zones, int source, int low,
+                            int high, int step, int layers) {
+  std::vector<int> roots;
+  for (int root = low; root <= high; root += step)
+    roots.push_back(root);
+  if (roots.back() + step / 2 < high)
+    roots.push_back(high);
+
+  // Each zone starts where the previous one ended; the last runs to high
+  int zoneLow = low;
+  for (size_t r = 0; r < roots.size(); ++r) {
+    const int root = roots[r];
+    const int zoneHigh =
+        r + 1 == roots.size() ? high : juce::jmin(high, root + step / 2);
+
+    for (int layer = 0; layer < layers; ++layer) {
+      Zone zone;
+      zone.rootNote = root;
+      zone.lowNote = zoneLow;
+      zone.highNote = zoneHigh;
+      zone.velocityLow = (float)layer / (float)layers;
+      zone.velocityHigh = (float)(layer + 1) / (float)layers;
+      zone.layer = layer;
+      zone.source = source;
+      zones.push_back(zone);
+    }
+    zoneLow = zoneHigh + 1;
+  }
+}
+
+HowlingSound *PatchFreezer::renderZone(HowlingSound &source,
+                                       const Patch &patch,
+                                       const Settings &settings,
+                                       const Zone &zone, double sampleRate,
+                                       const std::atomic<bool> &cancelled) {
+  const int blockSize = 512;
+  const int total =
+      juce::jmax(blockSize, (int)(settings.holdSeconds * sampleRate));
+
+  // 1. Private engine with the patch applied
+  SynthEngine engine;
+  engine.prepare(sampleRate, blockSize);
+  patch.applyTo(engine);
+  engine.addSound(&source);
+
+  // 2. Render the held note (mono: pan is applied again at playback)
+  juce::AudioBuffer<float> rendered(1, total);
+  rendered.clear();
+
+  juce::MidiBuffer midi;
+  midi.addEvent(juce::MidiMessage::noteOn(1, zone.rootNote, zone.velocityHigh),
+                0);
+
+  for (int pos = 0; pos < total; pos += blockSize) {
+    if (cancelled)
+      return nullptr;
+    engine.renderNextBlock(rendered, midi, pos,
+                           juce::jmin(blockSize, total - pos));
+  }
+
+  engine.allNotesOff(0, false);
+  engine.clearSounds();
+
+  // 3. Undo the render velocity: the sampler applies the played velocity
+  //    again, so notes inside a layer keep their dynamics
+  rendered.applyGain(1.0f / zone.velocityHigh);
+
+  // 4. Trim the silent end (decaying patches)
+  int length = total;
+  const auto *data = rendered.getReadPointer(0);
+  while (length > 1 && std::abs(data[length - 1]) < 1.0e-5f)
+    --length;
+
+  // 5. Optional WAV copy
+  if (settings.saveDirectory.isDirectory()) {
+    auto file = settings.saveDirectory.getChildFile(
+        juce::String::formatted("Freeze_%02d_%03d_v%d.wav", zone.source + 1,
+                                zone.rootNote, zone.layer + 1));
+    file.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (stream->openedOk()) {
+      juce::WavAudioFormat wav;
+      std::unique_ptr<juce::AudioFormatWriter> writer(
+          wav.createWriterFor(stream.get(), sampleRate, 1, 24, {}, 0));
+      if (writer != nullptr) {
+        stream.release(); // Owned by the writer now
+        writer->writeFromAudioSampleBuffer(rendered, 0, length);
+      }
+    }
+  }
+
+  // 6. New zone. Release time = patch release (the sampler's own envelope).
+  juce::BigInteger notes;
+  notes.setRange(zone.lowNote, zone.highNote - zone.lowNote + 1, true);
+
+  BufferAudioFormatReader reader(rendered, length, sampleRate);
+  auto *sound = new HowlingSound(
+      source.getName() + " (Frozen)", reader, notes, zone.rootNote, 0.0,
+      juce::jmax(0.001, (double)patch.release),
+      (double)(length + 1) / sampleRate,
+      source.isBassSample(), source.isOneShotSample());
+  sound->setVelocityRange(zone.velocityLow, zone.velocityHigh);
+  sound->setLayerIndex(zone.layer);
+  sound->setPadIndex(source.getPadIndex());
+  sound->setPadSettings(source.getPadSettings());
+  sound->setFrozen(true);
+  return sound;
+}
+
+void PatchFreezer::handleAsyncUpdate() {
+  juce::ReferenceCountedArray<HowlingSound> finished, sources;
+  {
+    const juce::ScopedLock sl(resultLock);
+    finished.swapWith(results);
+    sources.swapWith(frozenSources);
+  }
+
+  if (!cancelled && !finished.isEmpty() && onComplete)
+    onComplete(finished, sources);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "SynthEngine.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/**
+    Renders the current patch (sample + envelopes + filter) offline into a set
+    of new HowlingSound zones across a key range and velocity layers. Every
+    source sound (each pad / layer of a preset) is frozen over the keys it
+    covers inside that range, and its zones keep its pad rules and routing.
+
+    Frozen sounds play through HowlingVoice's static path: straight sample
+    playback, no envelopes, modulation or filter. For static patches this
+    sounds the same for a fraction of the CPU. Each zone holds a fixed length
+    of the note (Settings::holdSeconds); the release comes from the sampler's
+    own envelope, set to the patch release time.
+
+    Zones render in parallel on a private thread pool, each through its own
+    SynthEngine, so the live engine is never touched until the result is
+    swapped in on the message thread.
+*/
+class PatchFreezer : private juce::AsyncUpdater {
+public:
+  // Snapshot of the voice parameters, applied to the offline engine the same
+  // way processBlock applies them to the live one.
+  struct Patch {
+    float attack = 0.1f, decay = 0.1f, sustain = 1.0f, release = 0.1f;
+    float cutoff = 1000.0f, resonance = 0.5f;
+    int filterType = 0;
+    float lfoRate = 1.0f, lfoDepth = 0.0f;
+    float modAttack = 0.1f, modDecay = 0.1f, modSustain = 1.0f,
+          modRelease = 0.1f, modAmount = 0.5f;
+    int modTarget = 0;
+    float tune = 0.0f, sampleStart = 0.0f, sampleEnd = 1.0f;
+    bool loop = true;
+    float filterDrive = 0.0f;
+    int filterQuality = 1;
+    float envCurve = 0.0f;
+
+    void applyTo(SynthEngine &engine) const;
+  };
+
+  struct Settings {
+    int lowNote = 36;
+    int highNote = 84;
+    int noteStep = 3;       // One rendered root every noteStep semitones
+    int velocityLayers = 2; // Equal slices of the velocity range
+    double holdSeconds = 4.0;
+    juce::File saveDirectory; // Also write each zone as a WAV if set
+  };
+
+  PatchFreezer();
+  ~PatchFreezer() override;
+
+  // Starts rendering the sources in the background. Returns false if a
+  // freeze is already running or there is nothing to freeze.
+  bool freeze(const juce::ReferenceCountedArray<HowlingSound> &sources,
+              const Patch &patch, const Settings &settings,
+              double sampleRate);
+  void cancel();
+
+  bool isFreezing() const { return pendingZones.load() > 0; }
+  float getProgress() const;
+
+  // Called on the message thread with the finished zones and the sounds
+  // they replace
+  std::function<void(const juce::ReferenceCountedArray<HowlingSound> &frozen,
+                     const juce::ReferenceCountedArray<HowlingSound> &sources)>
+      onComplete;
+
+private:
+  struct Zone {
+    int lowNote, highNote, rootNote;
+    float velocityLow, velocityHigh;
+    int layer;
+    int source; // Index into the sources being frozen
+  };
+
+  // Roots every noteStep keys from low; a last root at high when the step
+  // would leave the top keys uncovered
+  static void addZones(std::vector<Zone> &zones, int source, int low,
+                       int high, int step, int layers);
+
+  static HowlingSound *renderZone(HowlingSound &source, const Patch &patch,
+                                  const Settings &settings, const Zone &zone,
+                                  double sampleRate,
+                                  const std::atomic<bool> &cancelled);
+
+  void handleAsyncUpdate() override;
+
+  juce::ThreadPool pool;
+  juce::CriticalSection resultLock;
+  juce::ReferenceCountedArray<HowlingSound> results;
+  juce::ReferenceCountedArray<HowlingSound> frozenSources;
+  std::atomic<int> pendingZones{0};
+  std::atomic<int> totalZones{0};
+  std::atomic<bool> cancelled{false};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchFreezer)
+};
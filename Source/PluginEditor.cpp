@@ -9,6 +9,9 @@ HowlingWolvesAudioProcessorEditor::HowlingWolvesAudioProcessorEditor(
       keyboardComponent(audioProcessor.getKeyboardState(),
                         juce::MidiKeyboardComponent::horizontalKeyboard),
       settingsTab(p), presetBrowser(audioProcessor.getPresetManager()) {
+  // EQ bar analysis only runs while the editor is open
+  audioProcessor.setMeteringActive(true);
+
   // Set LookAndFeel (Obsidian)
   setLookAndFeel(&obsidianLookAndFeel);
   tabs.setLookAndFeel(&obsidianLookAndFeel);
@@ -143,6 +146,8 @@ HowlingWolvesAudioProcessorEditor::~HowlingWolvesAudioProcessorEditor() {
   settingsButton.onClick = nullptr;
   tipsButton.onClick = nullptr;
 
+  audioProcessor.setMeteringActive(false);
+
   // Clean up look and feel
   stopTimer();
   setLookAndFeel(nullptr);
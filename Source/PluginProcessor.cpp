@@ -7,19 +7,61 @@ HowlingWolvesAudioProcessor::HowlingWolvesAudioProcessor()
           BusesProperties()
               // .withInput("Input", juce::AudioChannelSet::stereo(), true) //
               // Disabled to prevent feedback loop in Standalone
-              .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+              .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+              // Multi-out for pads / layers, off until the host enables them
+              .withOutput("Aux 1", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 2", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 3", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 4", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 5", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 6", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 7", juce::AudioChannelSet::stereo(), false)
+              .withOutput("Aux 8", juce::AudioChannelSet::stereo(), false)),
       apvts(*this, nullptr, "Parameters", createParameterLayout()),
       sampleManager(synthEngine), presetManager(apvts, sampleManager) {
 
   formatManager.registerBasicFormats();
   // Load initial samples
   sampleManager.loadSamples();
+
+  // Frozen zones replace the sounds they were rendered from once every zone
+  // has finished. Sounds loaded since then (other kits) are left alone, and
+  // a freeze whose sources were unloaded meanwhile is stale and dropped.
+  patchFreezer.onComplete =
+      [this](const juce::ReferenceCountedArray<HowlingSound> &frozen,
+             const juce::ReferenceCountedArray<HowlingSound> &sources) {
+        juce::Array<int> replaced;
+        for (int i = 0; i < synthEngine.getNumSounds(); ++i)
+          if (sources.contains(
+                  dynamic_cast<HowlingSound *>(synthEngine.getSound(i).get())))
+            replaced.add(i);
+        if (replaced.size() != sources.size())
+          return;
+
+        for (int i = replaced.size(); --i >= 0;)
+          synthEngine.removeSound(replaced[i]);
+        for (auto *sound : frozen)
+          synthEngine.addSound(sound);
+      };
+
+  // Everything the audio thread reads, found by name once
+  cacheParameters();
+
+  // The effects graph is recompiled on the message thread whenever the
+  // chain preset or a slot changes
+  for (const auto &id : getEffectsGraphParameterIDs())
+    apvts.addParameterListener(id, this);
+  updateEffectsGraph();
 }
 
 HowlingWolvesAudioProcessor::~HowlingWolvesAudioProcessor() {
   // Stop audio callback interaction immediately
   suspendProcessing(true);
 
+  for (const auto &id : getEffectsGraphParameterIDs())
+    apvts.removeParameterListener(id, this);
+  cancelPendingUpdate();
+
   // Safe shutdown: Clear synth/voices BEFORE SampleManager is destroyed
   synthEngine.clearSounds();
   synthEngine.clearVoices();
@@ -54,7 +96,11 @@ bool HowlingWolvesAudioProcessor::isMidiEffect() const {
 #endif
 }
 
-double HowlingWolvesAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double HowlingWolvesAudioProcessor::getTailLengthSeconds() const {
+  // Voices ring on for their release, then the effects for theirs
+  const double release = (double)load(params.release, 0.0f);
+  return release + (double)effectsProcessor.getTailLengthSeconds();
+}
 
 int HowlingWolvesAudioProcessor::getNumPrograms() {
   return 1; // NB: some hosts don't cope very well if you tell them there are 0
@@ -73,25 +119,180 @@ const juce::String HowlingWolvesAudioProcessor::getProgramName(int /*index*/) {
 void HowlingWolvesAudioProcessor::changeProgramName(
     int /*index*/, const juce::String & /*newName*/) {}
 
+//==============================================================================
+PatchFreezer::Patch HowlingWolvesAudioProcessor::capturePatch() {
+  auto value = [this](const char *id, float fallback) {
+    auto *param = apvts.getRawParameterValue(id);
+    return param != nullptr ? param->load() : fallback;
+  };
+
+  PatchFreezer::Patch patch;
+  patch.attack = value("attack", patch.attack);
+  patch.decay = value("decay", patch.decay);
+  patch.sustain = value("sustain", patch.sustain);
+  patch.release = value("release", patch.release);
+  patch.cutoff = value("filterCutoff", patch.cutoff);
+  patch.resonance = value("filterRes", patch.resonance);
+  patch.filterType = (int)value("filterType", 0.0f);
+  patch.lfoRate = value("lfoRate", patch.lfoRate);
+  patch.lfoDepth = value("lfoDepth", patch.lfoDepth);
+  patch.modAttack = value("modAttack", patch.modAttack);
+  patch.modDecay = value("modDecay", patch.modDecay);
+  patch.modSustain = value("modSustain", patch.modSustain);
+  patch.modRelease = value("modRelease", patch.modRelease);
+  patch.modAmount = value("modAmount", patch.modAmount);
+  patch.modTarget = (int)value("lfoTarget", 0.0f); // Used for Mod Target too
+  patch.tune = value("tune", patch.tune);
+  patch.sampleStart = value("sampleStart", patch.sampleStart);
+  patch.sampleEnd = value("sampleEnd", patch.sampleEnd);
+  patch.loop = value("sampleLoop", 1.0f) > 0.5f;
+  patch.filterDrive = value("filterDrive", patch.filterDrive);
+  patch.filterQuality = (int)value("filterQuality", 1.0f);
+  patch.envCurve = value("envCurve", patch.envCurve);
+  return patch;
+}
+
+bool HowlingWolvesAudioProcessor::freezePatch(
+    const PatchFreezer::Settings &settings) {
+  // Freeze every live (not already frozen) sound: all pads and layers
+  juce::ReferenceCountedArray<HowlingSound> sources;
+  for (int i = 0; i < synthEngine.getNumSounds(); ++i) {
+    auto *hs = dynamic_cast<HowlingSound *>(synthEngine.getSound(i).get());
+    if (hs != nullptr && !hs->isFrozenSample())
+      sources.add(hs);
+  }
+
+  const double rate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+  return patchFreezer.freeze(sources, capturePatch(), settings, rate);
+}
+
+juce::StringArray HowlingWolvesAudioProcessor::getEffectsGraphParameterIDs() {
+  juce::StringArray ids{"CHAIN_ORDER", "biteLookahead", "distOversampling"};
+  for (int slot = 1; slot <= EffectsProcessor::maxSlots; ++slot) {
+    const auto prefix = "fxSlot" + juce::String(slot);
+    for (const auto *suffix : {"Type", "Bypass", "Mix", "Parallel"})
+      ids.add(prefix + suffix);
+  }
+  return ids;
+}
+
+void HowlingWolvesAudioProcessor::parameterChanged(const juce::String &,
+                                                   float) {
+  // May arrive on the audio thread (automation): compile later, elsewhere
+  triggerAsyncUpdate();
+}
+
+void HowlingWolvesAudioProcessor::handleAsyncUpdate() {
+  updateEffectsGraph();
+  updateLatency();
+}
+
+void HowlingWolvesAudioProcessor::updateLatency() {
+  // Pipeline block plus whatever the effects graph delays by
+  setLatencySamples(effectsPipeline.getLatencySamples() +
+                    getEffectsLatency());
+}
+
+int HowlingWolvesAudioProcessor::getEffectsLatency() const {
+  return effectsProcessor.getLatencySamples(
+      (int)load(params.distOversampling, 1.0f),
+      load(params.biteLookahead, 0.0f));
+}
+
+void HowlingWolvesAudioProcessor::updateEffectsGraph() {
+  auto value = [this](const juce::String &id, float fallback) {
+    auto *p = apvts.getRawParameterValue(id);
+    return p != nullptr ? p->load() : fallback;
+  };
+
+  // CHAIN_ORDER presets, or the slot parameters for "Custom"
+  const int mode = (int)value("CHAIN_ORDER", 0.0f);
+  if (mode < customChainOrder) {
+    effectsProcessor.setGraph(EffectsProcessor::makePresetGraph(mode));
+    return;
+  }
+
+  EffectsProcessor::Graph graph;
+  for (int slot = 0; slot < EffectsProcessor::maxSlots; ++slot) {
+    const auto prefix = "fxSlot" + juce::String(slot + 1);
+    auto &s = graph[(size_t)slot];
+    s.type = (EffectsProcessor::EffectType)(int)value(prefix + "Type", 0.0f);
+    s.bypassed = value(prefix + "Bypass", 0.0f) > 0.5f;
+    s.mix = value(prefix + "Mix", 1.0f);
+    s.parallel = value(prefix + "Parallel", 0.0f) > 0.5f;
+  }
+  effectsProcessor.setGraph(graph);
+}
+
+void HowlingWolvesAudioProcessor::loadImpulseResponse(const juce::File &file) {
+  if (file.existsAsFile())
+    effectsProcessor.loadImpulseResponse(file);
+  else
+    effectsProcessor.clearImpulseResponse();
+}
+
 //==============================================================================
 void HowlingWolvesAudioProcessor::prepareToPlay(double sampleRate,
                                                 int samplesPerBlock) {
+  // The pipeline worker uses the effects: stop it before preparing them
+  effectsPipeline.release();
+
   synthEngine.setCurrentPlaybackSampleRate(sampleRate);
   synthEngine.prepare(sampleRate, samplesPerBlock);
+  sampleManager.setPlaybackSampleRate(sampleRate); // Load-time SRC
   midiProcessor.prepare(sampleRate);
   midiCapturer.prepare(sampleRate);
 
   juce::dsp::ProcessSpec spec;
   spec.sampleRate = sampleRate;
   spec.maximumBlockSize = samplesPerBlock;
-  spec.numChannels = getTotalNumOutputChannels();
+  spec.numChannels = getMainBusNumOutputChannels(); // Aux outs are dry
 
   effectsProcessor.prepare(spec);
+  filterProcessor.prepare(spec);
+  lfoProcessor.prepare(sampleRate);
+  globalFilterActive = false;
+
+  // Pipelined effects change the latency, so the mode is picked here.
+  // Offline renders gain nothing from the worker and stay serial.
+  auto *pipelineParam = apvts.getRawParameterValue("fxPipelined");
+  effectsPipelined =
+      pipelineParam != nullptr && pipelineParam->load() > 0.5f &&
+      !isNonRealtime();
+  if (effectsPipelined) {
+    effectsPipeline.prepare(
+        getMainBusNumOutputChannels(), samplesPerBlock,
+        [this](juce::AudioBuffer<float> &block,
+               const EffectsPipeline::Settings &settings) {
+          juce::AudioBuffer<float> main(
+              block.getArrayOfWritePointers(),
+              juce::jmin(settings.mainChannels, block.getNumChannels()),
+              block.getNumSamples());
+          effectsProcessor.updateParameters(settings.effects);
+          effectsProcessor.process(main);
+          applyMasterSection(main, settings.gain, settings.pan);
+        });
+  }
+  updateLatency();
+
+  // Room for the longest effects latency plus the pipeline block
+  auxDelayLines.setSize(2 * OutputRouting::maxAuxBuses,
+                        effectsProcessor.getMaxLatencySamples() +
+                            effectsPipeline.getLatencySamples() +
+                            subBlockSize);
+  auxDelayLines.clear();
+  auxDelay = 0;
+
+  // Room for dense MIDI (arp / chords) without allocating per block
+  subBlockMidi.ensureSize(2048);
+  subBlockMidiOut.ensureSize(8192);
 }
 
 void HowlingWolvesAudioProcessor::releaseResources() {
   // When playback stops, you can use this as an opportunity to free up any
   // spare memory, etc.
+  effectsPipeline.release();
+  effectsPipelined = false;
 }
 
 bool HowlingWolvesAudioProcessor::isBusesLayoutSupported(
@@ -100,29 +301,180 @@ bool HowlingWolvesAudioProcessor::isBusesLayoutSupported(
       layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
     return false;
 
+  // Aux buses: stereo or off
+  for (int i = 1; i < layouts.outputBuses.size(); ++i) {
+    const auto &set = layouts.getChannelSet(false, i);
+    if (!set.isDisabled() && set != juce::AudioChannelSet::stereo())
+      return false;
+  }
+
   return true;
 }
 
 void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                                juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
-  auto totalNumInputChannels = getTotalNumInputChannels();
-  auto totalNumOutputChannels = getTotalNumOutputChannels();
+  const int numSamples = buffer.getNumSamples();
+  subBlockMidiOut.clear();
+
+  // Play head and tempo: once per host block
+  updateTransport();
+
+  for (int start = 0; start < numSamples; start += subBlockSize) {
+    const int count = juce::jmin(subBlockSize, numSamples - start);
+
+    // Alias the host buffer (no copy, no allocation)
+    juce::AudioBuffer<float> subBuffer(buffer.getArrayOfWritePointers(),
+                                       buffer.getNumChannels(), start, count);
+
+    // This sub-block's events, re-timed to start at 0
+    subBlockMidi.clear();
+    for (auto it = midiMessages.findNextSamplePosition(start);
+         it != midiMessages.cend(); ++it) {
+      const auto event = *it;
+      if (event.samplePosition >= start + count)
+        break;
+      subBlockMidi.addEvent(event.data, event.numBytes,
+                            event.samplePosition - start);
+    }
 
-  // Clear the buffer to prevent static/garbage noise
-  buffer.clear();
+    updateSubBlockParameters();
+    processSubBlock(subBuffer, subBlockMidi);
+
+    // Whatever the MIDI chain produced goes back out on the host timeline
+    subBlockMidiOut.addEvents(subBlockMidi, 0, count, start);
+  }
+
+  midiMessages.swapWith(subBlockMidiOut);
+
+  // Pipelined effects: this block goes to the worker, and the one it
+  // finished meanwhile comes out. A host that switched to offline
+  // rendering since prepareToPlay gets the same delay, processed inline.
+  if (effectsPipelined)
+    effectsPipeline.process(buffer, pipelineSettings, !isNonRealtime());
+}
+
+void HowlingWolvesAudioProcessor::cacheParameters() {
+  auto raw = [this](const char *id) { return apvts.getRawParameterValue(id); };
+  auto choice = [this](const char *id) {
+    return dynamic_cast<juce::AudioParameterChoice *>(apvts.getParameter(id));
+  };
+  auto &p = params;
+
+  p.attack = raw("attack");
+  p.decay = raw("decay");
+  p.sustain = raw("sustain");
+  p.release = raw("release");
+  p.filterCutoff = raw("filterCutoff");
+  p.filterRes = raw("filterRes");
+  p.filterType = raw("filterType");
+  p.lfoRate = raw("lfoRate");
+  p.lfoDepth = raw("lfoDepth");
+  p.modAttack = raw("modAttack");
+  p.modDecay = raw("modDecay");
+  p.modSustain = raw("modSustain");
+  p.modRelease = raw("modRelease");
+  p.modAmount = raw("modAmount");
+  p.lfoTarget = raw("lfoTarget");
+  p.tune = raw("tune");
+  p.sampleStart = raw("sampleStart");
+  p.sampleEnd = raw("sampleEnd");
+  p.sampleLoop = raw("sampleLoop");
+  p.envCurve = raw("envCurve");
+  p.silenceThreshold = raw("silenceThreshold");
+  p.silenceHold = raw("silenceHold");
+  p.mpeEnabled = raw("mpeEnabled");
+  p.mpeBendRange = raw("mpeBendRange");
+  p.filterDrive = raw("filterDrive");
+  p.filterQuality = raw("filterQuality");
+  p.voiceMode = raw("voiceMode");
+  p.grainPosition = raw("grainPosition");
+  p.grainSpray = raw("grainSpray");
+  p.grainSize = raw("grainSize");
+  p.grainDensity = raw("grainDensity");
+  p.grainPitch = raw("grainPitch");
+  p.wtPosition = raw("wtPosition");
+  p.seqStretch = raw("seqStretch");
+
+  p.arpRate = choice("arpRate");
+  p.arpMode = choice("arpMode");
+  p.chordMode = choice("chordMode");
+  p.arpGate = raw("arpGate");
+  p.arpEnabled = raw("arpEnabled");
+  p.arpOctave = raw("arpOctave");
+  p.chordHold = raw("chordHold");
+  p.arpDensity = raw("arpDensity");
+  p.arpComplexity = raw("arpComplexity");
+  p.arpSpread = raw("arpSpread");
+  p.standaloneBPM = raw("standaloneBPM");
+
+  p.gain = raw("gain");
+  p.pan = raw("pan");
+  p.macroCrush = raw("macroCrush");
+  p.macroSpace = raw("macroSpace");
+
+  p.distDrive = raw("distDrive");
+  p.distOversampling = raw("distOversampling");
+  p.huntOn = raw("huntOn");
+  p.bitcrushOn = raw("bitcrushOn");
+  p.crushBits = raw("crushBits");
+  p.crushRate = raw("crushRate");
+  p.crushMix = raw("crushMix");
+  p.crushMacroBits = raw("crushMacroBits");
+  p.crushMacroRate = raw("crushMacroRate");
+  p.crushDither = raw("crushDither");
+  p.crushAntiAlias = raw("crushAntiAlias");
+  p.delayTime = raw("delayTime");
+  p.delayFeedback = raw("delayFeedback");
+  p.delayMix = raw("delayMix");
+  p.delaySync = raw("delaySync");
+  p.delayDivision = raw("delayDivision");
+  p.delayWidth = raw("delayWidth");
+  p.delayTone = raw("delayTone");
+  p.delayPingPong = raw("delayPingPong");
+  p.reverbSize = raw("reverbSize");
+  p.reverbDamping = raw("reverbDamping");
+  p.reverbDecay = raw("reverbDecay");
+  p.reverbMix = raw("REVERB_MIX");
+  p.convMix = raw("convMix");
+  p.bite = raw("BITE");
+  p.biteSustain = raw("biteSustain");
+  p.biteLookahead = raw("biteLookahead");
+
+  p.globalFilterType = raw("globalFilterType");
+  p.globalFilterCutoff = raw("globalFilterCutoff");
+  p.globalFilterRes = raw("globalFilterRes");
+  p.globalFilterVowel = raw("globalFilterVowel");
+  p.globalFilterLfoWave = raw("globalFilterLfoWave");
+  p.globalFilterLfoRate = raw("globalFilterLfoRate");
+  p.globalFilterLfoDepth = raw("globalFilterLfoDepth");
+
+  for (int pad = 0; pad < OutputRouting::numPads; ++pad)
+    p.padOut[(size_t)pad] =
+        apvts.getRawParameterValue("padOut" + juce::String(pad + 1));
+  for (int layer = 0; layer < OutputRouting::numLayers; ++layer)
+    p.layerOut[(size_t)layer] =
+        apvts.getRawParameterValue("layerOut" + juce::String(layer + 1));
+}
+
+void HowlingWolvesAudioProcessor::updateTransport() {
+  auto &p = params;
 
   // --- 0. Transport Logic (Host vs Internal) ---
+  // The play head is asked once per host block; the arp gets the tempo
+  // from here instead of asking again for every sub-block.
   juce::AudioPlayHead *playHead = getPlayHead();
+  juce::Optional<juce::AudioPlayHead::PositionInfo> position;
+  if (playHead)
+    position = playHead->getPosition();
+
   bool isPlaying = false;
   double bpm = 120.0;
 
-  if (playHead) {
-    if (auto pos = playHead->getPosition()) {
-      isPlaying = pos->getIsPlaying();
-      if (pos->getBpm().hasValue())
-        bpm = *pos->getBpm();
-    }
+  if (position) {
+    isPlaying = position->getIsPlaying();
+    if (position->getBpm().hasValue())
+      bpm = *position->getBpm();
   }
 
   // Update MidiCapturer BPM
@@ -158,40 +510,18 @@ void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     // `transportPlaying` variable in Processor.
   }
 
-  // (Optional) If we wanted to keep input (like an effect plugin), we wouldn't
-  // clear. But this is an Instrument. We must clear.
-
-  // This loop is redundant if we use buffer.clear(), but keeping it for
-  // safety/convention if logic changes
-  for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-    buffer.clear(i, 0, buffer.getNumSamples());
-
-  // --- MIDI Processing Stage ---
-  // 1. Process keyboard state (Input -> MidiBuffer)
-  keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(),
-                                      true);
-
-  // 2. Perform Midi Transformation (Arp / Chords)
-  // 2. Perform Midi Transformation (Arp / Chords)
+  // Tempo for the arp, the delay sync and the time-stretch
   float currentBPM = 120.0f;
-  if (auto *ph = getPlayHead()) {
-    if (auto pos = ph->getPosition()) {
-      if (pos->getBpm().hasValue()) {
-        currentBPM = (float)*pos->getBpm();
-      }
-    }
-  }
+  if (position && position->getBpm().hasValue())
+    currentBPM = (float)*position->getBpm();
 
   // If DAW BPM is invalid/missing (Standalone), use Internal.
-  float manualBPM = 120.0f;
-  if (auto *bpmParam = apvts.getRawParameterValue("standaloneBPM")) {
-    manualBPM = bpmParam->load();
-  }
+  const float manualBPM = load(p.standaloneBPM, 120.0f);
 
   if (currentBPM <= 0.0f || currentBPM == 120.0f) { // If default or invalid
     // Wait, 120 is default. But if DAW says 120, we shouldn't override?
     // Check playHead again. If ph is null, we are in Standalone.
-    if (!getPlayHead() || !getPlayHead()->getPosition()) {
+    if (!position) {
       currentBPM = manualBPM;
       internalBPM.store(currentBPM);
     }
@@ -205,150 +535,111 @@ void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   if (currentBPM == manualBPM)
     internalBPM.store(manualBPM);
 
-  // Pass currentBPM as fallback to MidiProcessor (it will use PlayHead if
-  // available, but this arg is for safety)
-  midiProcessor.process(midiMessages, buffer.getNumSamples(), getPlayHead(),
-                        currentBPM);
+  blockBpm = currentBPM;
+}
+
+void HowlingWolvesAudioProcessor::updateSubBlockParameters() {
+  auto &p = params;
+  const float currentBPM = blockBpm;
 
   // Read parameters from APVTS and apply to synth engine (Josh Hodge pattern)
-  auto *attackParam = apvts.getRawParameterValue("attack");
-  auto *decayParam = apvts.getRawParameterValue("decay");
-  auto *sustainParam = apvts.getRawParameterValue("sustain");
-  auto *releaseParam = apvts.getRawParameterValue("release");
-  auto *filterCutoffParam = apvts.getRawParameterValue("filterCutoff");
-  auto *filterResParam = apvts.getRawParameterValue("filterRes");
-  auto *lfoRateParam = apvts.getRawParameterValue("lfoRate");
-  auto *lfoDepthParam = apvts.getRawParameterValue("lfoDepth");
-
-  // Output Parameters
-  auto *gainParam = apvts.getRawParameterValue("gain");
-  auto *panParam = apvts.getRawParameterValue("pan");
-
-  // Effects Parameters
-  auto *distDrive = apvts.getRawParameterValue("distDrive");
-  auto *distMix = apvts.getRawParameterValue("distMix");
-  auto *delayTime = apvts.getRawParameterValue("delayTime");
-  auto *delayFdbk = apvts.getRawParameterValue("delayFeedback");
-  auto *delayMix = apvts.getRawParameterValue("delayMix");
-  auto *revSize = apvts.getRawParameterValue("reverbSize");
-  auto *revDamp = apvts.getRawParameterValue("reverbDamping");
-  auto *revMix = apvts.getRawParameterValue("REVERB_MIX");
-
-  // Apply parameters to synth engine
-  auto *filterTypeParam = apvts.getRawParameterValue("filterType");
-
-  // Apply parameters to synth engine
-  if (attackParam && decayParam && sustainParam && releaseParam &&
-      filterCutoffParam && filterResParam && lfoRateParam && lfoDepthParam &&
-      filterTypeParam) {
-
-    int fType = (int)filterTypeParam->load();
-
-    synthEngine.updateParams(
-        attackParam->load(), decayParam->load(), sustainParam->load(),
-        releaseParam->load(), filterCutoffParam->load(), filterResParam->load(),
-        fType, lfoRateParam->load(), lfoDepthParam->load());
+  if (p.attack && p.decay && p.sustain && p.release && p.filterCutoff &&
+      p.filterRes && p.lfoRate && p.lfoDepth && p.filterType) {
+
+    int fType = (int)p.filterType->load();
+
+    synthEngine.updateParams(p.attack->load(), p.decay->load(),
+                             p.sustain->load(), p.release->load(),
+                             p.filterCutoff->load(), p.filterRes->load(),
+                             fType, p.lfoRate->load(), p.lfoDepth->load());
 
     // Update Mod Env Params
-    auto *modA = apvts.getRawParameterValue("modAttack");
-    auto *modD = apvts.getRawParameterValue("modDecay");
-    auto *modS = apvts.getRawParameterValue("modSustain");
-    auto *modR = apvts.getRawParameterValue("modRelease");
-    auto *modAmt = apvts.getRawParameterValue("modAmount");
-    auto *lfoTgt =
-        apvts.getRawParameterValue("lfoTarget"); // Used for Mod Target too
-
-    if (modA && modD && modS && modR && modAmt && lfoTgt) {
+    if (p.modAttack && p.modDecay && p.modSustain && p.modRelease &&
+        p.modAmount && p.lfoTarget) {
       // Target: 0=Cutoff, 1=Vol, 2=Pan, 3=Pitch
-      int tgt = (int)lfoTgt->load();
-      synthEngine.updateModParams(modA->load(), modD->load(), modS->load(),
-                                  modR->load(), modAmt->load(), tgt);
+      int tgt = (int)p.lfoTarget->load();
+      synthEngine.updateModParams(p.modAttack->load(), p.modDecay->load(),
+                                  p.modSustain->load(), p.modRelease->load(),
+                                  p.modAmount->load(), tgt);
     }
   }
 
   // --- Update Midi Processor ---
-  auto *arpRateChoice =
-      dynamic_cast<juce::AudioParameterChoice *>(apvts.getParameter("arpRate"));
-  auto *arpModeChoice =
-      dynamic_cast<juce::AudioParameterChoice *>(apvts.getParameter("arpMode"));
-  auto *chordModeChoice = dynamic_cast<juce::AudioParameterChoice *>(
-      apvts.getParameter("chordMode"));
-
-  // Float/Int Params
-  float arpGate = *apvts.getRawParameterValue("arpGate");
-  bool arpOn = (bool)*apvts.getRawParameterValue("arpEnabled");
-  int arpOct = (int)*apvts.getRawParameterValue("arpOctave");
-  bool chordHold = (bool)*apvts.getRawParameterValue("chordHold");
-
-  // New Params
-  auto *arpDensityParam = apvts.getRawParameterValue("arpDensity");
-  auto *arpComplexityParam = apvts.getRawParameterValue("arpComplexity");
-  auto *arpSpreadParam = apvts.getRawParameterValue("arpSpread");
+  float arpGate = load(p.arpGate, 0.5f);
+  bool arpOn = load(p.arpEnabled, 0.0f) > 0.5f;
+  int arpOct = (int)load(p.arpOctave, 1.0f);
+  bool chordHold = load(p.chordHold, 0.0f) > 0.5f;
 
   // Default values if params missing (safe fallback)
-  float dens = arpDensityParam ? arpDensityParam->load() : 1.0f;
-  float comp = arpComplexityParam ? arpComplexityParam->load() : 0.0f;
-  float spread = arpSpreadParam ? arpSpreadParam->load() : 0.0f;
+  float dens = load(p.arpDensity, 1.0f);
+  float comp = load(p.arpComplexity, 0.0f);
+  float spread = load(p.arpSpread, 0.0f);
 
-  if (arpRateChoice && arpModeChoice) {
-    int rateIdx = arpRateChoice->getIndex(); // 0..3
-    int modeIdx = arpModeChoice->getIndex(); // 0..4
+  if (p.arpRate && p.arpMode) {
+    int rateIdx = p.arpRate->getIndex(); // 0..3
+    int modeIdx = p.arpMode->getIndex(); // 0..4
 
     // Map Rate Index to Float for MidiProcessor (temporary compatibility)
     midiProcessor.getArp().setParameters((float)rateIdx, modeIdx, arpOct,
                                          arpGate, arpOn, dens, comp, spread);
   }
 
-  if (chordModeChoice) {
-    int chordModeIdx = chordModeChoice->getIndex(); // 0..4
+  if (p.chordMode) {
+    int chordModeIdx = p.chordMode->getIndex(); // 0..4
     midiProcessor.getChordEngine().setParameters(chordModeIdx, 0, chordHold);
   }
 
-  // --- MIDI Capture (After processing, before Synth) ---
-  midiCapturer.processMidi(midiMessages, buffer.getNumSamples());
-
   // --- Sample & Tune Parameters ---
-  auto *tuneParam = apvts.getRawParameterValue("tune");
-  auto *startParam = apvts.getRawParameterValue("sampleStart");
-  auto *endParam = apvts.getRawParameterValue("sampleEnd");
-  auto *loopParam = apvts.getRawParameterValue("sampleLoop");
-
-  // Macros
-  auto *macroCrush = apvts.getRawParameterValue("macroCrush");
-  auto *macroSpace = apvts.getRawParameterValue("macroSpace");
-
-  float crushVal = macroCrush ? macroCrush->load() : 0.0f;
-  float spaceVal = macroSpace ? macroSpace->load() : 0.0f;
-
-  float tuneVal = tuneParam ? tuneParam->load() : 0.0f;
-  float startVal = startParam ? startParam->load() : 0.0f;
-  float endVal = endParam ? endParam->load() : 1.0f;
-  bool loopVal = loopParam ? (loopParam->load() > 0.5f) : true;
-
-  // Internal Transport Handling for Standalone
-  // Just ensure we pass valid context if needed.
-  // For now, Play/Stop buttons in UI will toggle `transportPlaying`.
-  // The actual effect depends on if Arp listens to "IsPlaying".
-  // Arp currently runs strictly on Note Input + Audio Callback samples.
-  // It doesn't seem to check "IsPlaying" global flag check inside Arp::process.
-  // So Play/Stop might be redundant unless we implement a "Sequencer runs
-  // without keys" mode. BUT: MidiCapturer DOES check `active` or `recording`
-  // state.
-
-  synthEngine.updateSampleParams(tuneVal, startVal, endVal, loopVal);
+  float crushVal = load(p.macroCrush, 0.0f);
+  float spaceVal = load(p.macroSpace, 0.0f);
+
+  synthEngine.updateSampleParams(load(p.tune, 0.0f), load(p.sampleStart, 0.0f),
+                                 load(p.sampleEnd, 1.0f),
+                                 load(p.sampleLoop, 1.0f) > 0.5f);
+
+  if (p.envCurve)
+    synthEngine.setEnvelopeCurve(p.envCurve->load());
+
+  if (p.silenceThreshold && p.silenceHold)
+    synthEngine.setSilenceDetection(p.silenceThreshold->load(),
+                                    p.silenceHold->load());
+
+  // --- MPE ---
+  if (p.mpeEnabled && p.mpeBendRange)
+    synthEngine.setMpe(p.mpeEnabled->load() > 0.5f, p.mpeBendRange->load());
+
+  // --- Voice Filter Drive ---
+  if (p.filterDrive && p.filterQuality)
+    synthEngine.updateFilterDrive(p.filterDrive->load(),
+                                  (int)p.filterQuality->load());
+
+  // --- Granular Parameters ---
+  if (p.voiceMode)
+    synthEngine.setVoiceMode((int)p.voiceMode->load());
+
+  GranularEngine::Parameters grainParams;
+  grainParams.position = load(p.grainPosition, grainParams.position);
+  grainParams.spray = load(p.grainSpray, grainParams.spray);
+  grainParams.sizeMs = load(p.grainSize, grainParams.sizeMs);
+  grainParams.density = load(p.grainDensity, grainParams.density);
+  grainParams.pitch = load(p.grainPitch, grainParams.pitch);
+  synthEngine.updateGranularParams(grainParams);
+
+  if (p.wtPosition)
+    synthEngine.setWavetablePosition(p.wtPosition->load());
+
+  // --- Sequence Time-Stretch ---
+  if (p.seqStretch)
+    synthEngine.setStretchEnabled(p.seqStretch->load() > 0.5f);
+  synthEngine.setHostBpm(currentBPM);
 
   // Apply parameters to effects processor
 
-  float distDriveVal = distDrive ? distDrive->load() : 0.0f;
+  float distDriveVal = load(p.distDrive, 0.0f);
   // Smart Mix: If Drive > 0 or Hunt/Bitcrush active, Mix = 1.0 (Audible), else
-  // 0.0 (Clean Bypass) We read the toggle states below (lines 282+), but we
-  // need them here for logic. Let's read them early.
-  bool huntIsOn = false;
-  bool bitcrushIsOn = false;
-  if (auto *p = apvts.getRawParameterValue("huntOn"))
-    huntIsOn = (bool)p->load();
-  if (auto *p = apvts.getRawParameterValue("bitcrushOn"))
-    bitcrushIsOn = (bool)p->load();
+  // 0.0 (Clean Bypass)
+  bool huntIsOn = load(p.huntOn, 0.0f) > 0.5f;
+  bool bitcrushIsOn = load(p.bitcrushOn, 0.0f) > 0.5f;
 
   float distMixTarget = 0.0f;
   if (distDriveVal > 0.01f || huntIsOn || bitcrushIsOn) {
@@ -362,12 +653,30 @@ void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   distDriveVal += (crushVal * 0.8f);
   distMixVal += (crushVal * 0.5f);
 
-  float delayTimeVal = delayTime ? delayTime->load() : 0.5f;
-  float delayFdbkVal = delayFdbk ? delayFdbk->load() : 0.3f; // Default 0.3
-  float delayMixVal = delayMix ? delayMix->load() : 0.0f;
-  float revSizeVal = revSize ? revSize->load() : 0.5f;
-  float revDampVal = revDamp ? revDamp->load() : 0.5f;
-  float revMixVal = revMix ? revMix->load() : 0.0f;
+  // Bitcrusher: on with its toggle, or brought in by the Crush macro, which
+  // also pulls the bit depth towards 2 bits and the rate towards 500 Hz by
+  // the two macro amounts
+  float crushBitsVal = load(p.crushBits, 8.0f);
+  float crushRateVal = load(p.crushRate, 11025.0f);
+  const float crushMixParam = load(p.crushMix, 1.0f);
+  const float macroBits = crushVal * load(p.crushMacroBits, 0.5f);
+  const float macroRate = crushVal * load(p.crushMacroRate, 0.5f);
+
+  crushBitsVal += (2.0f - crushBitsVal) * macroBits;
+  if (crushRateVal > 500.0f)
+    crushRateVal *= std::pow(500.0f / crushRateVal, macroRate);
+
+  float crushMixVal = bitcrushIsOn ? crushMixParam : 0.0f;
+  if (macroBits > 0.0f || macroRate > 0.0f)
+    crushMixVal = juce::jmax(crushMixVal,
+                             crushMixParam * juce::jmin(1.0f, 2.0f * crushVal));
+
+  float delayTimeVal = load(p.delayTime, 0.5f);
+  float delayFdbkVal = load(p.delayFeedback, 0.3f); // Default 0.3
+  float delayMixVal = load(p.delayMix, 0.0f);
+  float revSizeVal = load(p.reverbSize, 0.5f);
+  float revDampVal = load(p.reverbDamping, 0.5f);
+  float revMixVal = load(p.reverbMix, 0.0f);
 
   // Macro Space mapping: adds to Delay/Reverb Mix and Size
   delayMixVal += (spaceVal * 0.4f);
@@ -381,67 +690,198 @@ void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   revMixVal = juce::jlimit(0.0f, 1.0f, revMixVal);
   revSizeVal = juce::jlimit(0.0f, 1.0f, revSizeVal);
 
-  float biteVal = 0.0f;
-  if (auto *biteParam = apvts.getRawParameterValue("BITE"))
-    biteVal = *biteParam;
-
-  effectsProcessor.updateParameters(distDriveVal, distMixVal, delayTimeVal,
-                                    delayFdbkVal, delayMixVal, revSizeVal,
-                                    revDampVal, revMixVal, biteVal);
-
-  // Update Toggles
-  auto *huntParam = apvts.getRawParameterValue("huntOn");
-  auto *bitcrushParam = apvts.getRawParameterValue("bitcrushOn");
-  if (huntParam)
-    effectsProcessor.setHuntEnabled((bool)huntParam->load());
-  if (bitcrushParam)
-    effectsProcessor.setBitcrushEnabled((bool)bitcrushParam->load());
-
-  // Update Chain Order
-  auto *chainOrderParam = apvts.getRawParameterValue("CHAIN_ORDER");
-  if (chainOrderParam) {
-    int mode = (int)chainOrderParam->load();
-    using ET = EffectsProcessor::EffectType;
-    std::array<ET, 4> order;
-
-    // Standard: Dist -> Bite -> Delay -> Reverb
-    // Ethereal: Reverb -> Delay -> Dist -> Bite
-    // Chaos: Delay -> Dist -> Bite -> Reverb
-    // Reverse: Reverb -> Delay -> Bite -> Dist
-
-    switch (mode) {
-    default:
-    case 0:
-      order = {ET::Distortion, ET::TransientShaper, ET::Delay, ET::Reverb};
-      break;
-    case 1:
-      order = {ET::Reverb, ET::Delay, ET::Distortion, ET::TransientShaper};
-      break;
-    case 2:
-      order = {ET::Delay, ET::Distortion, ET::TransientShaper, ET::Reverb};
-      break;
-    case 3:
-      order = {ET::Reverb, ET::Delay, ET::TransientShaper, ET::Distortion};
-      break;
+  EffectsProcessor::Parameters fxParams;
+  fxParams.distDrive = distDriveVal;
+  fxParams.distMix = distMixVal;
+  fxParams.distOversampling =
+      (int)load(p.distOversampling, (float)fxParams.distOversampling);
+  fxParams.crushBits = crushBitsVal;
+  fxParams.crushRate = crushRateVal;
+  fxParams.crushMix = crushMixVal;
+  fxParams.crushDither = load(p.crushDither, 0.0f);
+  fxParams.crushAntiAlias = load(p.crushAntiAlias, 0.0f) > 0.5f;
+  fxParams.delayTime = delayTimeVal;
+  fxParams.delayFeedback = delayFdbkVal;
+  fxParams.delayMix = delayMixVal;
+  fxParams.delaySync =
+      load(p.delaySync, fxParams.delaySync ? 1.0f : 0.0f) > 0.5f;
+  fxParams.delayDivision =
+      (int)load(p.delayDivision, (float)fxParams.delayDivision);
+  fxParams.delayWidth = load(p.delayWidth, fxParams.delayWidth);
+  fxParams.delayTone = load(p.delayTone, fxParams.delayTone);
+  fxParams.delayPingPong =
+      load(p.delayPingPong, fxParams.delayPingPong ? 1.0f : 0.0f) > 0.5f;
+  fxParams.bpm = currentBPM;
+  fxParams.reverbSize = revSizeVal;
+  fxParams.reverbDamping = revDampVal;
+  fxParams.reverbDecay = load(p.reverbDecay, fxParams.reverbDecay);
+  fxParams.reverbMix = revMixVal;
+  fxParams.convolutionMix = load(p.convMix, fxParams.convolutionMix);
+  fxParams.offline = isNonRealtime();
+  fxParams.biteAmount = load(p.bite, 0.0f);
+  fxParams.biteSustain = load(p.biteSustain, 0.0f);
+  fxParams.biteLookahead = load(p.biteLookahead, 0.0f);
+  fxParams.hunt = huntIsOn;
+
+  // --- Master Section (Gain / Pan) ---
+  masterGain = load(p.gain, 0.5f);
+  masterPan = load(p.pan, 0.0f);
+  auxLatency = getEffectsLatency() + effectsPipeline.getLatencySamples();
+
+  // Pipelined: the worker owns the effects, so the settings travel with the
+  // host block instead (the worker runs it in one go, with the last
+  // sub-block's settings)
+  if (effectsPipelined) {
+    pipelineSettings.effects = fxParams;
+    pipelineSettings.gain = masterGain;
+    pipelineSettings.pan = masterPan;
+    pipelineSettings.mainChannels = getMainBusNumOutputChannels();
+  } else {
+    effectsProcessor.updateParameters(fxParams);
+  }
+
+  // --- Multi-out routing ---
+  for (int pad = 0; pad < OutputRouting::numPads; ++pad)
+    if (auto *out = p.padOut[(size_t)pad])
+      synthEngine.setPadOutput(pad, (int)out->load());
+  for (int layer = 0; layer < OutputRouting::numLayers; ++layer)
+    if (auto *out = p.layerOut[(size_t)layer])
+      synthEngine.setLayerOutput(layer, (int)out->load());
+}
+
+void HowlingWolvesAudioProcessor::processSubBlock(
+    juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) {
+  auto totalNumInputChannels = getTotalNumInputChannels();
+  auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+  // Clear the buffer to prevent static/garbage noise
+  buffer.clear();
+
+  // (Optional) If we wanted to keep input (like an effect plugin), we wouldn't
+  // clear. But this is an Instrument. We must clear.
+
+  // This loop is redundant if we use buffer.clear(), but keeping it for
+  // safety/convention if logic changes
+  for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    buffer.clear(i, 0, buffer.getNumSamples());
+
+  // --- MIDI Processing Stage ---
+  // 1. Process keyboard state (Input -> MidiBuffer)
+  keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(),
+                                      true);
+
+  // 2. Perform Midi Transformation (Arp / Chords). The tempo was read from
+  // the play head for the whole host block (updateTransport).
+  midiProcessor.process(midiMessages, buffer.getNumSamples(), nullptr,
+                        blockBpm);
+
+  // --- MIDI Capture (After processing, before Synth) ---
+  midiCapturer.processMidi(midiMessages, buffer.getNumSamples());
+
+  // Aux buses alias the host's channels (no copies); disabled ones are
+  // skipped and their voices fall back to the main output. They carry the
+  // dry voices: effects and the master section are main-bus only.
+  for (int bus = 1; bus <= OutputRouting::maxAuxBuses; ++bus) {
+    auto &aux = auxBusBuffers[(size_t)bus - 1];
+    if (bus < getBusCount(false) && getChannelCountOfBus(false, bus) > 0) {
+      aux = getBusBuffer(buffer, false, bus);
+      synthEngine.setAuxBus(bus, &aux);
+    } else {
+      synthEngine.setAuxBus(bus, nullptr);
     }
-    effectsProcessor.setChainOrder(order);
   }
 
+  auto mainBuffer = getBusBuffer(buffer, false, 0);
+
   // Process synth
-  synthEngine.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+  synthEngine.renderNextBlock(mainBuffer, midiMessages, 0,
+                              mainBuffer.getNumSamples());
+  delayAuxBuses(mainBuffer.getNumSamples());
 
-  // Process effects
-  effectsProcessor.process(buffer);
+  // Global filter on the summed voices, ahead of the effects
+  processGlobalFilter(mainBuffer);
 
-  // --- Master Section (Gain / Pan) ---
-  float gain = gainParam ? gainParam->load() : 0.5f;
-  float pan = panParam ? panParam->load() : 0.0f;
+  // Process effects (pipelined: after the whole host block, in processBlock)
+  if (!effectsPipelined) {
+    effectsProcessor.process(mainBuffer);
+    applyMasterSection(mainBuffer, masterGain, masterPan);
+  }
+
+  // Push to Visualizer - DISABLED (Unused and causing crash on exit)
+  // if (audioVisualizerHook)
+  //   audioVisualizerHook(buffer);
+}
+
+void HowlingWolvesAudioProcessor::delayAuxBuses(int numSamples) {
+  // A new amount restarts the lines (a click, like any latency change)
+  if (auxLatency != auxDelay) {
+    auxDelay = auxLatency;
+    auxDelayLines.clear();
+  }
+  if (auxDelay == 0 || numSamples + auxDelay > auxDelayLines.getNumSamples())
+    return;
+
+  for (int bus = 1; bus <= OutputRouting::maxAuxBuses; ++bus) {
+    if (bus >= getBusCount(false) || getChannelCountOfBus(false, bus) == 0)
+      continue;
+
+    auto &aux = auxBusBuffers[(size_t)bus - 1];
+    for (int ch = 0; ch < juce::jmin(2, aux.getNumChannels()); ++ch) {
+      auto *line = auxDelayLines.getWritePointer(2 * (bus - 1) + ch);
+      auto *data = aux.getWritePointer(ch);
+      juce::FloatVectorOperations::copy(line + auxDelay, data, numSamples);
+      juce::FloatVectorOperations::copy(data, line, numSamples);
+      std::memmove(line, line + numSamples,
+                   sizeof(float) * (size_t)auxDelay);
+    }
+  }
+}
 
+void HowlingWolvesAudioProcessor::processGlobalFilter(
+    juce::AudioBuffer<float> &buffer) {
+  const auto &p = params;
+
+  // 0 = Off, then the FilterProcessor types
+  const int type = (int)load(p.globalFilterType, 0.0f);
+  if (type == 0) {
+    globalFilterActive = false;
+    return;
+  }
+  if (!globalFilterActive) {
+    filterProcessor.reset(); // Start from silence, not stale state
+    lfoProcessor.reset();
+    globalFilterActive = true;
+  }
+
+  // One LFO value per sub-block: the filter interpolates in between
+  lfoProcessor.setWaveform(
+      (LFOProcessor::Waveform)(int)load(p.globalFilterLfoWave, 0.0f));
+  lfoProcessor.setRate(load(p.globalFilterLfoRate, 1.0f));
+  lfoProcessor.setDepth(load(p.globalFilterLfoDepth, 0.0f));
+  const float lfo = lfoProcessor.advance(buffer.getNumSamples());
+
+  const auto filterType = (FilterProcessor::FilterType)(type - 1);
+  filterProcessor.setFilterType(filterType);
+  filterProcessor.setResonance(load(p.globalFilterRes, 0.3f));
+
+  // Full depth sweeps the vowel half its range either way, or the cutoff
+  // two octaves either way
+  if (filterType == FilterProcessor::Formant)
+    filterProcessor.setVowel(load(p.globalFilterVowel, 0.0f) + 0.5f * lfo);
+  else
+    filterProcessor.setCutoff(load(p.globalFilterCutoff, 20000.0f) *
+                              std::exp2(2.0f * lfo));
+
+  filterProcessor.process(buffer);
+}
+
+void HowlingWolvesAudioProcessor::applyMasterSection(
+    juce::AudioBuffer<float> &buffer, float gain, float pan) {
   // Apply Master Gain
   buffer.applyGain(gain);
 
   // Apply Master Pan (Constant Power)
-  if (totalNumOutputChannels == 2) {
+  if (buffer.getNumChannels() == 2) {
     // Pan range -1.0 to 1.0
     float angle = (pan + 1.0f) * (juce::MathConstants<float>::pi / 4.0f);
     float leftGain = std::cos(angle);
@@ -450,10 +890,6 @@ void HowlingWolvesAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     buffer.applyGain(0, 0, buffer.getNumSamples(), leftGain);
     buffer.applyGain(1, 0, buffer.getNumSamples(), rightGain);
   }
-
-  // Push to Visualizer - DISABLED (Unused and causing crash on exit)
-  // if (audioVisualizerHook)
-  //   audioVisualizerHook(buffer);
 }
 
 // Helper to update all params including new ones
@@ -472,6 +908,10 @@ void HowlingWolvesAudioProcessor::getStateInformation(
     juce::MemoryBlock &destData) {
 
   auto state = apvts.copyState();
+  // The impulse response is saved by path and reloaded with the state
+  state.setProperty("irFile",
+                    effectsProcessor.getImpulseResponseFile().getFullPathName(),
+                    nullptr);
   std::unique_ptr<juce::XmlElement> xml(state.createXml());
   copyXmlToBinary(*xml, destData);
 }
@@ -484,6 +924,7 @@ void HowlingWolvesAudioProcessor::setStateInformation(const void *data,
   if (xmlState.get() != nullptr) {
     if (xmlState->hasTagName(apvts.state.getType())) {
       apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+      loadImpulseResponse(juce::File(apvts.state["irFile"].toString()));
     }
   }
 }
@@ -509,6 +950,37 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
                                                          0.0f, 1.0f, 1.0f));
   layout.add(std::make_unique<juce::AudioParameterFloat>("release", "Release",
                                                          0.01f, 5.0f, 0.1f));
+  // Voices whose tail stays below the threshold for the hold time are freed
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "silenceThreshold", "Silence Threshold",
+      juce::NormalisableRange<float>(-120.0f, -60.0f, 1.0f), -90.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "silenceHold", "Silence Hold",
+      juce::NormalisableRange<float>(1.0f, 500.0f, 1.0f, 0.5f), 50.0f));
+
+  // Segment shape for both envelopes: 0 = linear, 1 = exponential
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "envCurve", "Envelope Curve", 0.0f, 1.0f, 0.0f));
+
+  // Multi-out routing: each drum pad / velocity layer to Main or an aux bus
+  juce::StringArray outputChoices{"Main"};
+  for (int bus = 1; bus <= OutputRouting::maxAuxBuses; ++bus)
+    outputChoices.add("Aux " + juce::String(bus));
+  for (int pad = 1; pad <= OutputRouting::numPads; ++pad)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "padOut" + juce::String(pad), "Pad " + juce::String(pad) + " Output",
+        outputChoices, 0));
+  for (int layer = 1; layer <= OutputRouting::numLayers; ++layer)
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        "layerOut" + juce::String(layer),
+        "Layer " + juce::String(layer) + " Output", outputChoices, 0));
+
+  // MPE: per-note bend / pressure / timbre (one note per MIDI channel)
+  layout.add(std::make_unique<juce::AudioParameterBool>("mpeEnabled", "MPE",
+                                                        false));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "mpeBendRange", "MPE Bend Range",
+      juce::NormalisableRange<float>(1.0f, 96.0f, 1.0f), 48.0f));
 
   // Filter parameters
   layout.add(std::make_unique<juce::AudioParameterChoice>(
@@ -521,6 +993,10 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
       "filterRes", "Filter Resonance", 0.0f, 1.0f, 0.5f));
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "filterDrive", "Filter Drive", 0.0f, 1.0f, 0.0f));
+  // Oversampling for driven / high-resonance voice filters
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "filterQuality", "Filter Quality",
+      juce::StringArray{"Eco", "Standard", "High"}, 1));
 
   // LFO parameters
   layout.add(std::make_unique<juce::AudioParameterChoice>(
@@ -566,6 +1042,31 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
 
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "sampleLength", "Sample Length", 0.0f, 1.0f, 1.0f));
+
+  // Playback Mode (Granular is intended for Pads/Textures, Wavetable for
+  // sustained Leads/Pads)
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "voiceMode", "Voice Mode",
+      juce::StringArray{"Sample", "Granular", "Wavetable"}, 0));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "grainPosition", "Grain Position", 0.0f, 1.0f, 0.5f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "grainSpray", "Grain Spray", 0.0f, 1.0f, 0.1f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "grainSize", "Grain Size",
+      juce::NormalisableRange<float>(10.0f, 500.0f, 0.1f, 0.4f), 80.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "grainDensity", "Grain Density",
+      juce::NormalisableRange<float>(1.0f, 200.0f, 0.1f, 0.4f), 40.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "grainPitch", "Grain Pitch", -24.0f, 24.0f, 0.0f));
+
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "wtPosition", "Wavetable Position", 0.0f, 1.0f, 0.0f));
+
+  // Sequence loops: stretch to host tempo (pitch preserved)
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "seqStretch", "Sequence Tempo Sync", false));
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "ampVelocity", "Amp Velocity", 0.0f, 1.0f, 1.0f));
 
@@ -584,6 +1085,10 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "distMix", "Distortion Mix", 0.0f, 1.0f,
       1.0f)); // Default 1.0 (Fully Audible)
+  // Oversampling keeps heavy drive (Hunt / Crush) from aliasing
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "distOversampling", "Distortion Oversampling",
+      juce::StringArray{"1x", "2x", "4x", "8x"}, 1));
 
   // Toggles for Effects
   layout.add(
@@ -591,6 +1096,26 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
   layout.add(std::make_unique<juce::AudioParameterBool>("bitcrushOn",
                                                         "Bitcrush", false));
 
+  // Bitcrusher: continuous bit depth and held sample rate
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushBits", "Crush Bits",
+      juce::NormalisableRange<float>(1.0f, 16.0f, 0.0f, 0.6f), 8.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushRate", "Crush Rate",
+      juce::NormalisableRange<float>(200.0f, 48000.0f, 0.0f, 0.3f),
+      11025.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushMix", "Crush Mix", 0.0f, 1.0f, 1.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushDither", "Crush Dither", 0.0f, 1.0f, 0.0f));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "crushAntiAlias", "Crush Anti-Alias", false));
+  // How far the Crush macro pulls bits (to 2) and rate (to 500 Hz)
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushMacroBits", "Crush Macro Bits", 0.0f, 1.0f, 0.5f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "crushMacroRate", "Crush Macro Rate", 0.0f, 1.0f, 0.5f));
+
   // Delay
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "delayTime", "Delay Time", 0.0f, 2.0f, 0.5f));
@@ -599,26 +1124,45 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "delayMix", "Delay Mix", 0.0f, 1.0f, 0.0f));
 
-  // Delay Width? EffectsTab: dWidthSlider "delayWidth".
-  // Note: I missed checking EffectsTab source manually for mismatches.
-  // Assuming defaults for now, but adding width just in case user mentioned it
-  // previously. Actually, EffectsTab.cpp from older logs might have it. Safest
-  // to add commonly used ones if unsure. I will check EffectsTab ID in next
-  // step if verification fails. For now, Proceed.
+  // Stereo width of the echoes (0 = mono, 1 = full)
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "delayWidth", "Delay Width", 0.0f, 1.0f, 1.0f));
 
+  // Tempo sync (note divisions replace the free time), ping-pong and the
+  // feedback tone
+  layout.add(std::make_unique<juce::AudioParameterBool>("delaySync",
+                                                        "Delay Sync", false));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "delayDivision", "Delay Division", StereoDelay::getDivisionNames(), 5));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "delayPingPong", "Delay Ping-Pong", false));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "delayTone", "Delay Tone", 0.0f, 1.0f, 0.7f));
+
   // Reverb
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "reverbSize", "Reverb Size", 0.0f, 1.0f, 0.5f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "reverbDecay", "Reverb Decay", 0.0f, 1.0f, 0.5f)); // 0.3 s - 12 s
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "reverbDamping", "Reverb Damping", 0.0f, 1.0f, 0.5f));
   layout.add(std::make_unique<juce::AudioParameterFloat>(
       "REVERB_MIX", "Reverb Mix", 0.0f, 1.0f, 0.3f));
+  // Convolution with the loaded impulse response (silent until one is loaded)
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "convMix", "Convolution Mix", 0.0f, 1.0f, 0.0f));
 
   // Transient Shaper
   layout.add(std::make_unique<juce::AudioParameterFloat>("BITE", "Bite Amount",
                                                          -1.0f, 1.0f, 0.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "biteSustain", "Bite Sustain", -1.0f, 1.0f, 0.0f));
+  // Detector look-ahead in ms (0 = off); reported to the host as latency
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "biteLookahead", "Bite Look-ahead",
+      juce::NormalisableRange<float>(0.0f, TransientShaper::maxLookaheadMs,
+                                     0.1f),
+      0.0f));
 
   // --- MIDI Performance Parameters ---
   layout.add(std::make_unique<juce::AudioParameterBool>("arpEnabled", "Arp On",
@@ -660,7 +1204,55 @@ HowlingWolvesAudioProcessor::createParameterLayout() {
   // Signal Chain Order
   layout.add(std::make_unique<juce::AudioParameterChoice>(
       "CHAIN_ORDER", "Signal Chain",
-      juce::StringArray{"Standard", "Ethereal", "Chaos", "Reverse"}, 0));
+      juce::StringArray{"Standard", "Ethereal", "Chaos", "Reverse", "Custom"},
+      0));
+
+  // Global filter after the synth (Formant: vowel morph), with its own LFO
+  // on the vowel or cutoff
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "globalFilterType", "Global Filter",
+      juce::StringArray{"Off", "Low Pass", "High Pass", "Band Pass", "Notch",
+                        "Formant"},
+      0));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "globalFilterCutoff", "Global Filter Cutoff",
+      juce::NormalisableRange<float>(20.0f, 20000.0f, 0.0f, 0.25f),
+      20000.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "globalFilterRes", "Global Filter Resonance", 0.0f, 1.0f, 0.3f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "globalFilterVowel", "Global Filter Vowel", 0.0f, 1.0f, 0.0f));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "globalFilterLfoWave", "Global Filter LFO Waveform",
+      juce::StringArray{"Sine", "Square", "Triangle"}, 0));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "globalFilterLfoRate", "Global Filter LFO Rate",
+      juce::NormalisableRange<float>(0.05f, 20.0f, 0.0f, 0.4f), 1.0f));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "globalFilterLfoDepth", "Global Filter LFO Depth", 0.0f, 1.0f, 0.0f));
+
+  // Effects one block behind the synth on their own thread (adds one block
+  // of latency; takes effect the next time the host prepares playback)
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "fxPipelined", "FX Pipeline", false));
+
+  // Custom chain: effect slots in order. A parallel slot shares its input
+  // with the slot before it. Defaults spell out the Standard chain.
+  const juce::StringArray slotTypes{"Empty", "Distortion", "Bite", "Delay",
+                                    "Reverb"};
+  for (int slot = 1; slot <= EffectsProcessor::maxSlots; ++slot) {
+    const auto id = "fxSlot" + juce::String(slot);
+    const auto name = "FX Slot " + juce::String(slot);
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        id + "Type", name + " Effect", slotTypes,
+        slot < slotTypes.size() ? slot : 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        id + "Bypass", name + " Bypass", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        id + "Mix", name + " Mix", 0.0f, 1.0f, 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        id + "Parallel", name + " Parallel", false));
+  }
 
   return layout;
 }
@@ -1,18 +1,23 @@
 #pragma once
 
+#include "EffectsPipeline.h"
 #include "EffectsProcessor.h"
 #include "FilterProcessor.h"
 #include "HuntEngine.h"
 #include "LFOProcessor.h"
 #include "MidiCapturer.h"
 #include "MidiProcessor.h"
+#include "PatchFreezer.h"
 #include "PresetManager.h"
 #include "SampleManager.h"
 #include "SynthEngine.h"
 #include <JuceHeader.h>
 #include <atomic>
 
-class HowlingWolvesAudioProcessor : public juce::AudioProcessor {
+class HowlingWolvesAudioProcessor
+    : public juce::AudioProcessor,
+      private juce::AudioProcessorValueTreeState::Listener,
+      private juce::AsyncUpdater {
 public:
   //==============================================================================
   HowlingWolvesAudioProcessor();
@@ -59,16 +64,38 @@ public:
   HuntEngine &getHuntEngine() { return huntEngine; }
 
   MidiCapturer &getMidiCapturer() { return midiCapturer; }
+
+  // Patch freeze: renders the current patch into multisampled zones in the
+  // background, then swaps them in (see PatchFreezer)
+  bool freezePatch(const PatchFreezer::Settings &settings);
+  PatchFreezer &getPatchFreezer() { return patchFreezer; }
   MidiProcessor &getMidiProcessor() { return midiProcessor; }
 
+  // Convolution reverb IR: loaded and resampled in the background. A missing
+  // file clears it.
+  void loadImpulseResponse(const juce::File &file);
+  juce::File getImpulseResponseFile() const {
+    return effectsProcessor.getImpulseResponseFile();
+  }
+  bool isImpulseResponseLoading() const {
+    return effectsProcessor.isImpulseResponseLoading();
+  }
+
   // Transport Control (Internal)
   void setTransportPlaying(bool shouldPlay) { transportPlaying = shouldPlay; }
   bool isTransportPlaying() const { return transportPlaying; }
 
   // Metering Accessors
-  float getEqLow() const { return effectsProcessor.eqLow; }
-  float getEqMid() const { return effectsProcessor.eqMid; }
-  float getEqHigh() const { return effectsProcessor.eqHigh; }
+  BandMeter::Levels getMeterLevels() const {
+    return effectsProcessor.getMeterLevels();
+  }
+  float getEqLow() const { return getMeterLevels().low; }
+  float getEqMid() const { return getMeterLevels().mid; }
+  float getEqHigh() const { return getMeterLevels().high; }
+  // The editor switches the band analysis on while it is open
+  void setMeteringActive(bool active) {
+    effectsProcessor.setMeteringEnabled(active);
+  }
 
   // Shared Resources for UI
   juce::AudioFormatManager formatManager;
@@ -96,21 +123,127 @@ public:
 private:
   //==============================================================================
   juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+  // MIDI dispatch, parameter reads (cached pointers), voice and effect
+  // parameter updates, rendering and modulation run once per sub-block, so
+  // their timing does not depend on the host buffer size. Only the play
+  // head is asked once per host block.
+  static constexpr int subBlockSize = 32;
+  void updateTransport();
+  void updateSubBlockParameters();
+  void processSubBlock(juce::AudioBuffer<float> &buffer,
+                       juce::MidiBuffer &midiMessages);
+  float blockBpm = 120.0f;
+  float masterGain = 0.5f, masterPan = 0.0f;
+
+  // The aux buses carry dry voices, so they skip the effects' latency and
+  // the pipeline's block; they are delayed by the same amount (the reported
+  // latency, read per sub-block) to stay in line with the main bus. One
+  // [carried samples | sub-block] line per aux channel, sized in
+  // prepareToPlay.
+  juce::AudioBuffer<float> auxDelayLines;
+  int auxLatency = 0, auxDelay = 0;
+  void delayAuxBuses(int numSamples);
+  juce::MidiBuffer subBlockMidi;
+  juce::MidiBuffer subBlockMidiOut;
+  PatchFreezer::Patch capturePatch();
+
+  // Effects graph: CHAIN_ORDER presets or the fxSlot parameters ("Custom"),
+  // compiled on the message thread after any of them changes. The Bite
+  // look-ahead and the distortion oversampling are listened to as well:
+  // they move the reported latency.
+  static constexpr int customChainOrder = 4;
+  static juce::StringArray getEffectsGraphParameterIDs();
+  void parameterChanged(const juce::String &parameterID,
+                        float newValue) override;
+  void handleAsyncUpdate() override;
+  void updateEffectsGraph();
+  void updateLatency();
+  // Distortion oversampling plus shaper look-ahead, as the graph has them
+  int getEffectsLatency() const;
+
+  // Global filter between the synth and the effects (off by default)
+  void processGlobalFilter(juce::AudioBuffer<float> &buffer);
+  bool globalFilterActive = false;
+
+  // Master gain and constant-power pan, after the effects
+  static void applyMasterSection(juce::AudioBuffer<float> &buffer, float gain,
+                                 float pan);
+
   juce::AudioProcessorValueTreeState apvts;
 
+  // Raw values of every parameter the audio thread reads, looked up by name
+  // once (cacheParameters) so processBlock never searches the parameter map.
+  // A pointer is null if its parameter is missing from the layout.
+  struct ParameterPointers {
+    using Value = std::atomic<float> *;
+
+    // Voices
+    Value attack{}, decay{}, sustain{}, release{};
+    Value filterCutoff{}, filterRes{}, filterType{}, lfoRate{}, lfoDepth{};
+    Value modAttack{}, modDecay{}, modSustain{}, modRelease{}, modAmount{},
+        lfoTarget{};
+    Value tune{}, sampleStart{}, sampleEnd{}, sampleLoop{}, envCurve{};
+    Value silenceThreshold{}, silenceHold{}, mpeEnabled{}, mpeBendRange{};
+    Value filterDrive{}, filterQuality{}, voiceMode{};
+    Value grainPosition{}, grainSpray{}, grainSize{}, grainDensity{},
+        grainPitch{};
+    Value wtPosition{}, seqStretch{};
+
+    // MIDI
+    juce::AudioParameterChoice *arpRate{}, *arpMode{}, *chordMode{};
+    Value arpGate{}, arpEnabled{}, arpOctave{}, chordHold{};
+    Value arpDensity{}, arpComplexity{}, arpSpread{}, standaloneBPM{};
+
+    // Master and macros
+    Value gain{}, pan{}, macroCrush{}, macroSpace{};
+
+    // Effects
+    Value distDrive{}, distOversampling{}, huntOn{}, bitcrushOn{};
+    Value crushBits{}, crushRate{}, crushMix{}, crushMacroBits{},
+        crushMacroRate{}, crushDither{}, crushAntiAlias{};
+    Value delayTime{}, delayFeedback{}, delayMix{}, delaySync{},
+        delayDivision{}, delayWidth{}, delayTone{}, delayPingPong{};
+    Value reverbSize{}, reverbDamping{}, reverbDecay{}, reverbMix{},
+        convMix{};
+    Value bite{}, biteSustain{}, biteLookahead{};
+
+    // Global filter
+    Value globalFilterType{}, globalFilterCutoff{}, globalFilterRes{},
+        globalFilterVowel{}, globalFilterLfoWave{}, globalFilterLfoRate{},
+        globalFilterLfoDepth{};
+
+    // Multi-out routing
+    std::array<Value, OutputRouting::numPads> padOut{};
+    std::array<Value, OutputRouting::numLayers> layerOut{};
+  };
+  void cacheParameters();
+  static float load(const std::atomic<float> *value, float fallback) {
+    return value != nullptr ? value->load() : fallback;
+  }
+  ParameterPointers params;
+
   SampleManager sampleManager;
   SynthEngine synthEngine;
+  PatchFreezer patchFreezer; // After synthEngine: stops its jobs first
   juce::MidiKeyboardState keyboardState;
   PresetManager presetManager;
 
-  // Filter and LFO
+  // Global filter and the LFO that modulates it
   FilterProcessor filterProcessor;
   LFOProcessor lfoProcessor;
   EffectsProcessor effectsProcessor;
+  EffectsPipeline effectsPipeline; // After effectsProcessor: stops first
+  EffectsPipeline::Settings pipelineSettings; // Filled per sub-block
+  bool effectsPipelined = false;
   MidiProcessor midiProcessor;
   HuntEngine huntEngine;
   MidiCapturer midiCapturer;
 
+  // Aux output views for the current sub-block (alias the host buffer)
+  std::array<juce::AudioBuffer<float>, OutputRouting::maxAuxBuses>
+      auxBusBuffers;
+
   std::atomic<bool> transportPlaying{false};
   std::atomic<float> internalBPM{120.0f};
 
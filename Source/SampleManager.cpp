@@ -4,7 +4,7 @@ SampleManager::SampleManager(SynthEngine &s) : synthEngine(s) {
   formatManager.registerBasicFormats();
 }
 
-SampleManager::~SampleManager() {}
+SampleManager::~SampleManager() { workerPool.removeAllJobs(true, 10000); }
 
 // Helper to get standard location with priority search
 void SampleManager::loadSamples() {
@@ -139,15 +139,24 @@ void SampleManager::loadSound(const juce::File &file) {
       }
     }
 
-    auto *sound =
-        new HowlingSound(file.getFileNameWithoutExtension(), *reader, allNotes,
-                         rootNote, 0.0, 100.0, 60.0, isBass, isOneShot);
+    auto *sound = new HowlingSound(file.getFileNameWithoutExtension(),
+                                   *reader, allNotes, rootNote, 0.0, 100.0,
+                                   60.0, isBass, isOneShot, isSequence);
+    sound->setSourceFile(file);
 
     synthEngine.addSound(sound);
+    requestConversion(file, sound);
+
+    if (isSequence)
+      requestLoopAnalysis(file, sound);
+    else if (!isOneShot)
+      requestWavetable(file, sound);
   } else {
     DBG("Failed to load sample: " + file.getFullPathName());
   }
 
+  // The sounds cleared above no longer pin their cache entries
+  pruneCaches();
   sendChangeMessage();
 }
 
@@ -182,17 +191,248 @@ void SampleManager::loadDrumKit(const juce::File &kitDirectory) {
       reader->metadataValues.remove("Loop0Start");
       reader->metadataValues.remove("Loop0End");
 
+      auto fileName = file.getFileNameWithoutExtension();
       auto *sound =
-          new HowlingSound(file.getFileNameWithoutExtension(), *reader, noteMap,
+          new HowlingSound(stripPadTags(fileName), *reader, noteMap,
                            midiNote,       // Root note = played note
                            0.0, 0.1, 60.0, // Fast attack
                            false, true);   // isBass=false, isOneShot=true
 
+      // Choke group / voice limits (hats, rolls) from the filename
+      sound->setPadSettings(parsePadTags(fileName));
+      sound->setPadIndex(count); // Multi-out routing (padOut params)
+      sound->setSourceFile(file);
+
       synthEngine.addSound(sound);
+      requestConversion(file, sound);
       midiNote++;
       count++;
     }
   }
+
+  pruneCaches();
+}
+
+HowlingSound::PadSettings
+SampleManager::parsePadTags(const juce::String &name) {
+  HowlingSound::PadSettings settings;
+
+  auto readTag = [&name](const juce::String &tag) {
+    auto start = name.indexOfIgnoreCase("[" + tag + "=");
+    if (start < 0)
+      return 0;
+    return name.substring(start + tag.length() + 2)
+        .upToFirstOccurrenceOf("]", false, false)
+        .getIntValue();
+  };
+
+  settings.chokeGroup = juce::jlimit(0, 16, readTag("choke"));
+  settings.maxVoices = juce::jmax(0, readTag("max"));
+  settings.reservedVoices = juce::jmax(0, readTag("reserve"));
+  return settings;
+}
+
+juce::String SampleManager::stripPadTags(const juce::String &name) {
+  juce::String result;
+  int pos = 0;
+
+  while (pos < name.length()) {
+    auto open = name.indexOfChar(pos, '[');
+    auto close = open >= 0 ? name.indexOfChar(open, ']') : -1;
+    if (open < 0 || close < 0) {
+      result += name.substring(pos);
+      break;
+    }
+
+    auto tag = name.substring(open + 1, close);
+    result += name.substring(pos, open);
+    if (!tag.containsChar('=')) // Not one of ours: keep it
+      result += name.substring(open, close + 1);
+    pos = close + 1;
+  }
+
+  return result.trim();
+}
+
+void SampleManager::requestLoopAnalysis(const juce::File &file,
+                                        HowlingSound *sound) {
+  auto key = getCacheKey(file);
+
+  {
+    const juce::ScopedLock sl(analysisLock);
+    auto cached = analysisCache.find(key);
+    if (cached != analysisCache.end()) {
+      touch(cached->second);
+      sound->retainCachedData(cached->second.value);
+      sound->setLoopAnalysis(cached->second.value.get());
+      return;
+    }
+  }
+
+  // Hold a reference so the sound outlives the job even if it is replaced
+  juce::ReferenceCountedObjectPtr<HowlingSound> soundPtr(sound);
+
+  workerPool.addJob([this, soundPtr, key] {
+    auto analysis = std::make_shared<LoopAnalysis>(LoopAnalysis::analyse(
+        *soundPtr->getAudioData(), soundPtr->getLength(),
+        soundPtr->getSourceSampleRate()));
+
+    const juce::ScopedLock sl(analysisLock);
+    auto &entry = analysisCache[key];
+    if (entry.value == nullptr)
+      entry.value = std::move(analysis);
+    touch(entry);
+
+    soundPtr->retainCachedData(entry.value);
+    soundPtr->setLoopAnalysis(entry.value.get());
+  });
+}
+
+void SampleManager::requestWavetable(const juce::File &file,
+                                     HowlingSound *sound) {
+  auto key = getCacheKey(file);
+
+  {
+    const juce::ScopedLock sl(analysisLock);
+    auto cached = wavetableCache.find(key);
+    if (cached != wavetableCache.end()) {
+      touch(cached->second);
+      sound->retainCachedData(cached->second.value);
+      sound->setWavetable(cached->second.value.get());
+      return;
+    }
+  }
+
+  juce::ReferenceCountedObjectPtr<HowlingSound> soundPtr(sound);
+
+  workerPool.addJob([this, soundPtr, key] {
+    std::shared_ptr<Wavetable> table = Wavetable::build(
+        *soundPtr->getAudioData(), soundPtr->getLength(),
+        soundPtr->getSourceSampleRate());
+
+    const juce::ScopedLock sl(analysisLock);
+    auto &entry = wavetableCache[key];
+    if (entry.value == nullptr)
+      entry.value = std::move(table); // Unpitched material caches as nullptr
+    touch(entry);
+
+    soundPtr->retainCachedData(entry.value);
+    soundPtr->setWavetable(entry.value.get());
+  });
+}
+
+void SampleManager::setPlaybackSampleRate(double sampleRate) {
+  if (sampleRate <= 0.0 || sampleRate == playbackSampleRate.load())
+    return;
+
+  playbackSampleRate = sampleRate;
+
+  {
+    // The sound list may change on the message thread meanwhile. Every
+    // voice was stopped by the synth's own rate change, so the old-rate
+    // conversions are released here, not kept alongside the new ones.
+    const juce::ScopedLock sl(synthEngine.getLock());
+    for (int i = 0; i < synthEngine.getNumSounds(); ++i) {
+      if (auto *hs =
+              dynamic_cast<HowlingSound *>(synthEngine.getSound(i).get())) {
+        hs->setConvertedSample(nullptr);
+        if (hs->getSourceFile() != juce::File())
+          requestConversion(hs->getSourceFile(), hs);
+      }
+    }
+  }
+
+  // Conversions to the old rate are never looked up again
+  pruneCaches();
+}
+
+void SampleManager::requestConversion(const juce::File &file,
+                                      HowlingSound *sound) {
+  const double rate = playbackSampleRate.load();
+
+  // Unknown host rate (not prepared yet) or already at the host rate:
+  // juce::SamplerVoice plays the native data 1:1
+  if (rate <= 0.0 || sound->getSourceSampleRate() == rate) {
+    sound->setConvertedSample(nullptr);
+    return;
+  }
+
+  auto key = getCacheKey(file) + "@" + juce::String(rate);
+
+  {
+    const juce::ScopedLock sl(analysisLock);
+    auto cached = conversionCache.find(key);
+    if (cached != conversionCache.end()) {
+      touch(cached->second);
+      sound->setConvertedSample(cached->second.value);
+      return;
+    }
+  }
+
+  juce::ReferenceCountedObjectPtr<HowlingSound> soundPtr(sound);
+
+  workerPool.addJob([this, soundPtr, key, rate] {
+    std::shared_ptr<ConvertedSample> converted = ConvertedSample::convert(
+        *soundPtr->getAudioData(), soundPtr->getLength(),
+        soundPtr->getSourceSampleRate(), rate);
+
+    const juce::ScopedLock sl(analysisLock);
+
+    // A later rate change may have overtaken this job: its result would
+    // never be looked up again, so it is not cached either
+    if (rate != playbackSampleRate.load())
+      return;
+
+    auto &entry = conversionCache[key];
+    if (entry.value == nullptr)
+      entry.value = std::move(converted);
+    touch(entry);
+
+    soundPtr->setConvertedSample(entry.value);
+  });
+}
+
+template <typename T> void SampleManager::touch(CacheEntry<T> &entry) {
+  entry.lastUsed = ++cacheClock;
+}
+
+template <typename T> void SampleManager::evictUnused(Cache<T> &cache) {
+  // Unused = only the cache holds it (or nothing was built)
+  std::vector<typename Cache<T>::iterator> unused;
+  for (auto it = cache.begin(); it != cache.end(); ++it)
+    if (it->second.value.use_count() <= 1)
+      unused.push_back(it);
+
+  if (unused.size() <= maxUnusedCacheEntries)
+    return;
+
+  std::sort(unused.begin(), unused.end(), [](const auto &a, const auto &b) {
+    return a->second.lastUsed < b->second.lastUsed;
+  });
+  for (size_t i = 0; i < unused.size() - maxUnusedCacheEntries; ++i)
+    cache.erase(unused[i]);
+}
+
+void SampleManager::pruneCaches() {
+  const juce::ScopedLock sl(analysisLock);
+
+  const auto rateSuffix = "@" + juce::String(playbackSampleRate.load());
+  for (auto it = conversionCache.begin(); it != conversionCache.end();) {
+    if (!it->first.endsWith(rateSuffix))
+      it = conversionCache.erase(it); // Sounds still using it keep it alive
+    else
+      ++it;
+  }
+
+  evictUnused(analysisCache);
+  evictUnused(wavetableCache);
+  evictUnused(conversionCache);
+}
+
+juce::String SampleManager::getCacheKey(const juce::File &file) {
+  // Path + timestamp so an edited file is analysed again
+  return file.getFullPathName() + "@" +
+         juce::String(file.getLastModificationTime().toMilliseconds());
 }
 
 juce::String SampleManager::getCurrentSamplePath() const {
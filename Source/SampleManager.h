@@ -2,6 +2,8 @@
 
 #include "SynthEngine.h"
 #include <JuceHeader.h>
+#include <map>
+#include <memory>
 
 //==============================================================================
 /**
@@ -18,8 +20,58 @@ public:
 
   juce::String getCurrentSamplePath() const;
 
+  // Host rate for load-time SRC. Called from prepareToPlay; a new rate
+  // re-converts every loaded sound in the background.
+  void setPlaybackSampleRate(double sampleRate);
+
 private:
+  // Tempo/beat analysis for Sequence loops runs on the worker pool and is
+  // cached per file, so reloading a loop (or switching presets) is instant.
+  void requestLoopAnalysis(const juce::File &file, HowlingSound *sound);
+
+  // Same idea for Wavetable mode: slice tonal samples into single cycles.
+  void requestWavetable(const juce::File &file, HowlingSound *sound);
+
+  // Resamples a sound to the host rate (cached per file and rate)
+  void requestConversion(const juce::File &file, HowlingSound *sound);
+
+  static juce::String getCacheKey(const juce::File &file);
+
+  // Cache entries are shared with the sounds that use them (see
+  // HowlingSound::retainCachedData), so evicting one only frees its memory
+  // once no loaded sound or playing voice needs it. Entries no sound uses
+  // are kept for quick reloads, least recently used first out, up to
+  // maxUnusedCacheEntries per cache.
+  template <typename T> struct CacheEntry {
+    std::shared_ptr<T> value;
+    juce::uint64 lastUsed = 0;
+  };
+  template <typename T>
+  using Cache = std::map<juce::String, CacheEntry<T>>;
+
+  static constexpr size_t maxUnusedCacheEntries = 16;
+  template <typename T> void touch(CacheEntry<T> &entry);
+  template <typename T> static void evictUnused(Cache<T> &cache);
+  // Drops other-rate conversions and trims unused entries (analysisLock)
+  void pruneCaches();
+
+  // Drum pad rules from filename tags, e.g. "Open Hat [choke=1] [max=2]".
+  // Supported: [choke=N] (1-16), [max=N] voices, [reserve=N] voices.
+  static HowlingSound::PadSettings parsePadTags(const juce::String &name);
+  static juce::String stripPadTags(const juce::String &name);
+
   SynthEngine &synthEngine;
   juce::AudioFormatManager formatManager;
   juce::String currentSamplePath;
+
+  juce::CriticalSection analysisLock;
+  Cache<LoopAnalysis> analysisCache;
+  Cache<Wavetable> wavetableCache;
+  Cache<ConvertedSample> conversionCache;
+  juce::uint64 cacheClock = 0;
+  std::atomic<double> playbackSampleRate{0.0};
+
+  juce::ThreadPool workerPool{juce::ThreadPoolOptions{}
+                                  .withThreadName("Sample Worker")
+                                  .withNumberOfThreads(2)};
 };
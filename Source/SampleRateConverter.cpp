@@ -0,0 +1,79 @@
+#include "SampleRateConverter.h"
+
+namespace {
+// Zero-phase elliptic low-pass (run forwards, then backwards) for
+// downsampling. juce::WindowedSincInterpolator does not band-limit when it
+// decimates, so everything above the new Nyquist would fold back into the
+// audio band. Flat to 0.45 x the target rate, -120 dB from its Nyquist.
+void bandLimit(float *data, int numSamples, double sourceRate,
+               double targetRate) {
+  using Design = juce::dsp::FilterDesign<double>;
+  const auto sections = Design::designIIRLowpassHighOrderEllipticMethod(
+      0.475 * targetRate, sourceRate, 0.05 * targetRate / sourceRate, -0.05,
+      -60.0);
+
+  std::vector<juce::dsp::IIR::Filter<double>> filters;
+  for (auto *coefficients : sections)
+    filters.emplace_back(coefficients);
+
+  auto run = [&](int start, int end, int step) {
+    for (auto &filter : filters)
+      filter.reset();
+    for (int i = start; i != end; i += step) {
+      double x = (double)data[i];
+      for (auto &filter : filters)
+        x = filter.processSample(x);
+      data[i] = (float)x;
+    }
+  };
+
+  run(0, numSamples, 1);
+  run(numSamples - 1, -1, -1);
+}
+} // namespace
+
+std::unique_ptr<ConvertedSample>
+ConvertedSample::convert(const juce::AudioBuffer<float> &source,
+                         int sourceLength, double sourceRate,
+                         double targetRate) {
+  sourceLength = juce::jmin(sourceLength, source.getNumSamples());
+  if (sourceLength <= 0 || sourceRate <= 0.0 || targetRate <= 0.0)
+    return nullptr;
+
+  // Input samples consumed per output sample
+  const double ratio = sourceRate / targetRate;
+
+  // The interpolator delays its output by its base latency (in input
+  // samples); render that much extra and drop it from the front.
+  const int latency = (int)std::ceil(
+      (double)juce::WindowedSincInterpolator::getBaseLatency() / ratio);
+  const int outputLength = (int)std::ceil((double)sourceLength / ratio);
+
+  // Trailing zeros let the filter ring out past the last source sample
+  const int padding = (int)std::ceil((double)(latency + 8) * ratio) + 256;
+
+  auto result = std::make_unique<ConvertedSample>();
+  result->sampleRate = targetRate;
+  result->length = outputLength;
+  result->data.setSize(source.getNumChannels(), outputLength);
+
+  std::vector<float> input((size_t)(sourceLength + padding), 0.0f);
+  std::vector<float> output((size_t)(outputLength + latency), 0.0f);
+  juce::WindowedSincInterpolator interpolator;
+
+  for (int ch = 0; ch < source.getNumChannels(); ++ch) {
+    std::copy(source.getReadPointer(ch),
+              source.getReadPointer(ch) + sourceLength, input.begin());
+    std::fill(input.begin() + sourceLength, input.end(), 0.0f);
+    if (ratio > 1.0) // Filtered in place, padding and all (its tail rings on)
+      bandLimit(input.data(), (int)input.size(), sourceRate, targetRate);
+
+    interpolator.reset();
+    interpolator.process(ratio, input.data(), output.data(),
+                         (int)output.size());
+
+    result->data.copyFrom(ch, 0, output.data() + latency, outputLength);
+  }
+
+  return result;
+}
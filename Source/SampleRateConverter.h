@@ -0,0 +1,24 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    A copy of a sample resampled to the host rate, so a note at its root pitch
+    plays back 1:1 with no interpolation at all.
+
+    Built once at load time (and again when the host rate changes) with a
+    windowed-sinc interpolator, which is far cleaner than the per-note linear
+    interpolation juce::SamplerVoice does on top of the pitch ratio. When the
+    target rate is lower the source is low-passed first, since the
+    interpolator itself does not band-limit.
+*/
+struct ConvertedSample {
+  juce::AudioBuffer<float> data;
+  double sampleRate = 0.0;
+  int length = 0;
+
+  // Slow: call it from a worker thread. Returns nullptr on bad input.
+  static std::unique_ptr<ConvertedSample>
+  convert(const juce::AudioBuffer<float> &source, int sourceLength,
+          double sourceRate, double targetRate);
+};
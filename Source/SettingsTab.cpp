@@ -1,7 +1,6 @@
 #include "SettingsTab.h"
 
 SettingsTab::SettingsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
-  juce::ignoreUnused(audioProcessor);
   // --- MIDI Section ---
   addAndMakeVisible(midiLabel);
   midiLabel.setText("MIDI SETTINGS", juce::dontSendNotification);
@@ -21,6 +20,13 @@ SettingsTab::SettingsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
   midiChannelBox.setJustificationType(juce::Justification::centred);
   midiChannelBox.setTooltip("Selects the MIDI input channel.");
 
+  addAndMakeVisible(mpeToggle);
+  mpeToggle.setTooltip("MIDI Polyphonic Expression: per-note pitch bend, "
+                       "pressure and timbre (CC74) from MPE controllers.");
+  mpeAtt =
+      std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+          audioProcessor.getAPVTS(), "mpeEnabled", mpeToggle);
+
   // --- UI Section ---
   addAndMakeVisible(uiLabel);
   uiLabel.setText("INTERFACE", juce::dontSendNotification);
@@ -76,9 +82,35 @@ SettingsTab::SettingsTab(HowlingWolvesAudioProcessor &p) : audioProcessor(p) {
     // Implement panic functionality (clear voices)
     // audioProcessor.clearVoices(); // Need to implement this in processor
   };
+
+  addAndMakeVisible(freezeButton);
+  freezeButton.setButtonText("FREEZE PATCH");
+  freezeButton.setTooltip("Renders every pad and layer of the current patch "
+                          "into multisampled zones and plays those instead, "
+                          "for a fraction of the CPU.");
+  freezeButton.onClick = [this] {
+    if (audioProcessor.freezePatch({})) {
+      freezeButton.setEnabled(false);
+      startTimerHz(10);
+    }
+  };
 }
 
-SettingsTab::~SettingsTab() {}
+SettingsTab::~SettingsTab() { stopTimer(); }
+
+void SettingsTab::timerCallback() {
+  auto &freezer = audioProcessor.getPatchFreezer();
+  if (freezer.isFreezing()) {
+    freezeButton.setButtonText(
+        "FREEZING " +
+        juce::String(juce::roundToInt(freezer.getProgress() * 100.0f)) + "%");
+    return;
+  }
+
+  stopTimer();
+  freezeButton.setButtonText("FREEZE PATCH");
+  freezeButton.setEnabled(true);
+}
 
 void SettingsTab::paint(juce::Graphics &g) {
   auto area = getLocalBounds().reduced(20);
@@ -121,6 +153,10 @@ void SettingsTab::resized() {
       juce::FlexItem(midiChannelLabel).withWidth(60).withHeight(30));
   midiFlex.items.add(
       juce::FlexItem(midiChannelBox).withWidth(100).withHeight(30));
+  midiFlex.items.add(juce::FlexItem(mpeToggle)
+                         .withWidth(70)
+                         .withHeight(30)
+                         .withMargin({0, 0, 0, 10}));
   midiFlex.performLayout(midiArea);
 
   // Layout UI
@@ -145,6 +181,10 @@ void SettingsTab::resized() {
                           .withWidth(150)
                           .withHeight(30)
                           .withMargin({20, 0, 0, 0}));
+  aboutFlex.items.add(juce::FlexItem(freezeButton)
+                          .withWidth(150)
+                          .withHeight(30)
+                          .withMargin({10, 0, 0, 0}));
 
   aboutFlex.performLayout(aboutArea);
 }
@@ -5,13 +5,14 @@
 #include <JuceHeader.h>
 
 //==============================================================================
-class SettingsTab : public juce::Component {
+class SettingsTab : public juce::Component, public juce::Timer {
 public:
   SettingsTab(HowlingWolvesAudioProcessor &p);
   ~SettingsTab() override;
 
   void paint(juce::Graphics &g) override;
   void resized() override;
+  void timerCallback() override;
 
 private:
   HowlingWolvesAudioProcessor &audioProcessor;
@@ -21,6 +22,8 @@ private:
   juce::Label midiLabel;
   juce::ComboBox midiChannelBox;
   juce::Label midiChannelLabel;
+  juce::ToggleButton mpeToggle{"MPE"};
+  std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> mpeAtt;
 
   // UI Settings
   juce::GroupComponent uiGroup;
@@ -33,5 +36,9 @@ private:
   juce::Label versionLabel;
   juce::TextButton panicButton;
 
+  // Patch freeze: renders every pad / layer into frozen zones (progress is
+  // polled while it runs)
+  juce::TextButton freezeButton;
+
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SettingsTab)
 };
@@ -0,0 +1,214 @@
+#include "StereoDelay.h"
+
+namespace {
+struct Division {
+  const char *name;
+  double beats; // Quarter notes
+};
+
+const std::array<Division, 14> divisions{{{"1/32", 0.125},
+                                          {"1/16T", 0.25 * 2.0 / 3.0},
+                                          {"1/16", 0.25},
+                                          {"1/16D", 0.375},
+                                          {"1/8T", 0.5 * 2.0 / 3.0},
+                                          {"1/8", 0.5},
+                                          {"1/8D", 0.75},
+                                          {"1/4T", 2.0 / 3.0},
+                                          {"1/4", 1.0},
+                                          {"1/4D", 1.5},
+                                          {"1/2T", 2.0 * 2.0 / 3.0},
+                                          {"1/2", 2.0},
+                                          {"1/2D", 3.0},
+                                          {"1/1", 4.0}}};
+} // namespace
+
+juce::StringArray StereoDelay::getDivisionNames() {
+  juce::StringArray names;
+  for (const auto &division : divisions)
+    names.add(division.name);
+  return names;
+}
+
+double StereoDelay::getDivisionBeats(int index) {
+  return divisions[(size_t)juce::jlimit(0, (int)divisions.size() - 1, index)]
+      .beats;
+}
+
+void StereoDelay::prepare(double newSampleRate, int maximumBlockSize) {
+  sampleRate = newSampleRate;
+
+  // Longest time either mode can ask for, plus room for one block's glide
+  double longestBeats = 0.0;
+  for (const auto &division : divisions)
+    longestBeats = juce::jmax(longestBeats, division.beats);
+  const double longestSeconds =
+      juce::jmax(maxFreeSeconds, longestBeats * 60.0 / minSyncBpm);
+
+  lineFrames = (int)std::ceil(longestSeconds * sampleRate) + maximumBlockSize +
+               2;
+  line.assign((size_t)lineFrames * 2, 0.0f);
+
+  delayTime.prepare(sampleRate, smoothingSeconds);
+  mix.prepare(sampleRate, smoothingSeconds);
+  delayRamp.resize((size_t)maximumBlockSize);
+  mixRamp.resize((size_t)maximumBlockSize);
+  wetBuffer.setSize(2, maximumBlockSize);
+
+  highCoeff = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * 60.0f /
+                              (float)sampleRate);
+  setParameters(params);
+  reset();
+}
+
+void StereoDelay::reset() {
+  std::fill(line.begin(), line.end(), 0.0f);
+  writePos = 0;
+  delayValid = false;
+  lowState = {};
+  highState = {};
+}
+
+void StereoDelay::setParameters(const Parameters &newParams) {
+  if (newParams.tone != params.tone || lowCoeff == 1.0f) {
+    // Tone 0 - 1 maps to a 1 kHz - 18 kHz feedback low-pass
+    const float cutoff = 1000.0f * std::pow(18.0f, newParams.tone);
+    lowCoeff = 1.0f - std::exp(-juce::MathConstants<float>::twoPi * cutoff /
+                               (float)sampleRate);
+  }
+  params = newParams;
+}
+
+float StereoDelay::getTargetDelaySamples() const {
+  double seconds = params.timeSeconds;
+  if (params.sync && params.bpm > 0.0)
+    seconds = getDivisionBeats(params.division) * 60.0 /
+              juce::jmax(minSyncBpm, params.bpm);
+
+  return (float)juce::jlimit(1.0, (double)lineFrames - 2.0,
+                             seconds * sampleRate);
+}
+
+float StereoDelay::getTailSeconds() const {
+  if (params.mix < 1.0e-4f || line.empty())
+    return 0.0f;
+
+  const float seconds = getTargetDelaySamples() / (float)sampleRate;
+  const float feedback = juce::jlimit(0.0f, 0.999f, std::abs(params.feedback));
+  const float repeats =
+      feedback > 1.0e-3f ? std::log(0.001f) / std::log(feedback) : 0.0f;
+  return juce::jmin(maxTailSeconds, seconds * (1.0f + repeats));
+}
+
+void StereoDelay::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  if (numSamples == 0 || buffer.getNumChannels() == 0 || line.empty())
+    return;
+
+  // Longer than prepared (should not happen): in wet-buffer-sized pieces
+  const int maxSamples = wetBuffer.getNumSamples();
+  if (numSamples > maxSamples) {
+    for (int start = 0; start < numSamples; start += maxSamples) {
+      const int count = juce::jmin(maxSamples, numSamples - start);
+      juce::AudioBuffer<float> piece(buffer.getArrayOfWritePointers(),
+                                     buffer.getNumChannels(), start, count);
+      process(piece);
+    }
+    return;
+  }
+
+  // One smoothing step per block for the mix, ramped across it
+  mix.setTarget(params.mix);
+  mix.next(numSamples);
+
+  if (mix.getStart() < 1.0e-4f && mix.getEnd() < 1.0e-4f) {
+    idle = true; // Nothing audible: leave the line alone
+    return;
+  }
+  if (idle) {
+    reset(); // Do not replay whatever was left in the line
+    idle = false;
+  }
+
+  // Delay time: retarget once per block, glide linearly across it
+  delayTime.setTarget(getTargetDelaySamples());
+  if (!delayValid) {
+    delayTime.snapToTarget();
+    delayValid = true;
+  }
+  delayTime.next(numSamples);
+  const float *delays = delayTime.fill(delayRamp.data(), numSamples)
+                            ? delayRamp.data()
+                            : nullptr;
+  const float steadyDelay = delayTime.getEnd();
+
+  auto *left = buffer.getWritePointer(0);
+  auto *right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1)
+                                            : nullptr;
+  auto *wetL = wetBuffer.getWritePointer(0);
+  auto *wetR = wetBuffer.getWritePointer(1);
+
+  const float feedback = params.feedback;
+  const float sideGain = 0.5f * params.width;
+  const bool pingPong = params.pingPong;
+  float *frames = line.data();
+
+  // 1. The line (recursive): wet signal only
+  for (int i = 0; i < numSamples; ++i) {
+    // One read position and weight for both channels. The whole and the
+    // fractional delay stay apart: as one float position on a line this
+    // long, the fraction would be rounded away.
+    const float delaySamples = delays != nullptr ? delays[i] : steadyDelay;
+    const int whole = (int)delaySamples;
+    const float frac = delaySamples - (float)whole;
+    int i0 = writePos - whole;
+    if (i0 < 0)
+      i0 += lineFrames;
+    const int i1 = i0 > 0 ? i0 - 1 : lineFrames - 1; // One frame older
+
+    const float *f0 = frames + 2 * i0;
+    const float *f1 = frames + 2 * i1;
+    const float delayedL = f0[0] + frac * (f1[0] - f0[0]);
+    const float delayedR = f0[1] + frac * (f1[1] - f0[1]);
+
+    // Feedback tone (low-pass minus its 60 Hz low end)
+    lowState[0] += lowCoeff * (delayedL - lowState[0]);
+    lowState[1] += lowCoeff * (delayedR - lowState[1]);
+    highState[0] += highCoeff * (lowState[0] - highState[0]);
+    highState[1] += highCoeff * (lowState[1] - highState[1]);
+    const float fbL = (lowState[0] - highState[0]) * feedback;
+    const float fbR = (lowState[1] - highState[1]) * feedback;
+
+    const float inL = left[i];
+    const float inR = right != nullptr ? right[i] : inL;
+
+    float *w = frames + 2 * writePos;
+    if (pingPong) {
+      // Mono input enters on the left and bounces across
+      w[0] = 0.5f * (inL + inR) + fbR;
+      w[1] = fbL;
+    } else {
+      w[0] = inL + fbL;
+      w[1] = inR + fbR;
+    }
+    if (++writePos == lineFrames)
+      writePos = 0;
+
+    // Width on the wet signal only
+    const float mid = 0.5f * (delayedL + delayedR);
+    const float side = (delayedL - delayedR) * sideGain;
+    wetL[i] = mid + side;
+    wetR[i] = mid - side;
+  }
+
+  // 2. Mix (vector): dry stays at unity, the wet is added on top
+  using FVO = juce::FloatVectorOperations;
+  if (mix.fill(mixRamp.data(), numSamples)) {
+    FVO::addWithMultiply(left, wetL, mixRamp.data(), numSamples);
+    if (right != nullptr)
+      FVO::addWithMultiply(right, wetR, mixRamp.data(), numSamples);
+  } else {
+    FVO::addWithMultiply(left, wetL, mix.getEnd(), numSamples);
+    if (right != nullptr)
+      FVO::addWithMultiply(right, wetR, mix.getEnd(), numSamples);
+  }
+}
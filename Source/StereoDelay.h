@@ -0,0 +1,75 @@
+#pragma once
+#include "BlockRamp.h"
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+/**
+    Stereo echo for the effects chain: free time or host-synced divisions
+    (straight, dotted, triplet), ping-pong, stereo width and a tone filter in
+    the feedback path.
+
+    The two channels live interleaved in one line, so each output frame is a
+    single read position and interpolation weight shared by the L/R pair
+    rather than two independent delay lines. The delay time is retargeted
+    once per block and glides linearly across it; nothing is recomputed per
+    sample. The recursive loop only produces the wet signal; the mix is
+    applied afterwards as vector operations (ramped or constant). The line
+    is sized for the longest synced time at the slowest supported tempo, so
+    switching divisions never reallocates.
+*/
+class StereoDelay {
+public:
+  struct Parameters {
+    float timeSeconds = 0.5f; // Free time
+    bool sync = false;
+    int division = 5; // Index into getDivisionNames()
+    double bpm = 120.0;
+    float feedback = 0.3f;
+    float mix = 0.0f;
+    float width = 1.0f; // 0 = mono echoes, 1 = full stereo
+    float tone = 0.7f;  // Feedback low-pass, 0 = dark, 1 = open
+    bool pingPong = false;
+  };
+
+  // Note values for the sync choice parameter, and their length in beats
+  static juce::StringArray getDivisionNames();
+  static double getDivisionBeats(int index);
+
+  void prepare(double newSampleRate, int maximumBlockSize);
+  void reset();
+
+  void setParameters(const Parameters &newParams);
+  void process(juce::AudioBuffer<float> &buffer);
+
+  // Time for the repeats to fall by 60 dB (capped), 0 while fully dry
+  float getTailSeconds() const;
+
+private:
+  static constexpr double maxFreeSeconds = 2.0;
+  static constexpr float maxTailSeconds = 30.0f;
+  static constexpr double minSyncBpm = 40.0;
+  static constexpr double smoothingSeconds = 0.05;
+
+  float getTargetDelaySamples() const;
+
+  Parameters params;
+  double sampleRate = 44100.0;
+
+  std::vector<float> line; // Interleaved L/R frames
+  int lineFrames = 0;
+  int writePos = 0;
+
+  BlockRamp delayTime, mix;
+  bool delayValid = false; // false = jump to the target on the next block
+  bool idle = true;        // Fully dry: the line is not running
+
+  // Per-block work (prepare)
+  std::vector<float> delayRamp, mixRamp;
+  juce::AudioBuffer<float> wetBuffer;
+
+  // Feedback tone: one-pole low-pass, then a one-pole high-pass at 60 Hz so
+  // repeats do not build up mud
+  std::array<float, 2> lowState{}, highState{};
+  float lowCoeff = 1.0f, highCoeff = 0.0f;
+};
@@ -8,14 +8,8 @@ HowlingVoice::HowlingVoice() {
   // Placeholder init
   lfo.initialise([](float x) { return std::sin(x); });
 
-  // Initialize ADSR with default
-  adsr.setSampleRate(44100.0); // Will be updated in prepare
-  adsrParams = {0.1f, 0.1f, 1.0f, 0.1f};
+  // Envelopes start with their defaults (0.1s / 0.1s / 1.0 / 0.1s, linear)
   adsr.setParameters(adsrParams);
-
-  // Initialize Mod ADSR
-  modAdsr.setSampleRate(44100.0);
-  modAdsrParams = {0.1f, 0.1f, 1.0f, 0.1f};
   modAdsr.setParameters(modAdsrParams);
 }
 
@@ -37,12 +31,16 @@ void HowlingVoice::prepare(double sampleRate, int samplesPerBlock) {
   spec.maximumBlockSize = samplesPerBlock;
   spec.numChannels = 1; // Mono voice
 
-  filter.prepare(spec);
-  filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+  voiceFilter.prepare(sampleRate, samplesPerBlock);
 
   lfo.prepare(spec);
 
-  adsr.setSampleRate(sampleRate);
+  adsr.prepare(sampleRate, samplesPerBlock);
+  modAdsr.prepare(sampleRate, samplesPerBlock);
+
+  granular.prepare(sampleRate, samplesPerBlock);
+  stretcher.prepare(sampleRate);
+  wavetableOsc.prepare(sampleRate);
 
   // Prepare crossover filter for Bass (120Hz)
   crossoverFilter.prepare(spec);
@@ -51,36 +49,19 @@ void HowlingVoice::prepare(double sampleRate, int samplesPerBlock) {
 
   // Resize temp buffer for processing
   tempBuffer.setSize(1, samplesPerBlock); // Mono voice
+  cutoffBuffer.resize((size_t)samplesPerBlock);
+  modEnvBuffer.resize((size_t)samplesPerBlock);
 }
 
 void HowlingVoice::updateFilter(float cutoff, float resonance, int filterType) {
   baseCutoff = cutoff;
-  baseResonance = resonance;
-  filter.setCutoffFrequency(cutoff);
-  filter.setResonance(resonance);
-
-  switch (filterType) {
-  case 0:
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    isNotch = false;
-    break;
-  case 1:
-    filter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    isNotch = false;
-    break;
-  case 2:
-    filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-    isNotch = false;
-    break;
-  case 3:
-    filter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
-    isNotch = true;
-    break;
-  default:
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    isNotch = false;
-    break;
-  }
+  voiceFilter.setResonance(resonance);
+  voiceFilter.setType(filterType); // 0=LP, 1=HP, 2=BP, 3=Notch
+}
+
+void HowlingVoice::updateFilterDrive(float drive, int quality) {
+  voiceFilter.setDrive(drive);
+  voiceFilter.setQuality(quality);
 }
 
 void HowlingVoice::updateLFO(float rate, float depth) {
@@ -97,6 +78,13 @@ void HowlingVoice::updateADSR(float attack, float decay, float sustain,
   adsr.setParameters(adsrParams);
 }
 
+void HowlingVoice::setEnvelopeCurve(float curve) {
+  adsrParams.curve = curve;
+  adsr.setParameters(adsrParams);
+  modAdsrParams.curve = curve;
+  modAdsr.setParameters(modAdsrParams);
+}
+
 void HowlingVoice::updateSampleParams(float tune, float sampleStart,
                                       float sampleEnd, bool loop) {
   tuneSemitones = tune;
@@ -107,6 +95,51 @@ void HowlingVoice::updateSampleParams(float tune, float sampleStart,
 
 void HowlingVoice::setPan(float newPan) { pan = newPan; }
 
+void HowlingVoice::updateGranularParams(
+    const GranularEngine::Parameters &params) {
+  granular.setParameters(params);
+}
+
+void HowlingVoice::setWavetablePosition(float position) {
+  wavetableOsc.setPosition(position);
+}
+
+void HowlingVoice::setHostBpm(double bpm) {
+  hostBpm = bpm;
+  if (isStretchNote && loopBpm > 0.0)
+    stretcher.setSpeed(hostBpm / loopBpm);
+}
+
+void HowlingVoice::setSilenceDetection(float thresholdDb, float holdMs) {
+  silenceThreshold = juce::Decibels::decibelsToGain(thresholdDb, -200.0f);
+  silenceHoldSamples = juce::jmax(
+      1, (int)(holdMs * 0.001 * (getSampleRate() > 0.0 ? getSampleRate()
+                                                        : 44100.0)));
+}
+
+bool HowlingVoice::updateSilenceDetector(const float *data, int numSamples) {
+  const auto range =
+      juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+  const float peak = juce::jmax(-range.getStart(), range.getEnd());
+
+  if (peak >= silenceThreshold) {
+    hasSounded = true;
+    silentSamples = 0;
+    return false;
+  }
+
+  // Leading silence in a sample is not a tail
+  if (!hasSounded)
+    return false;
+
+  silentSamples += numSamples;
+
+  // Frozen notes release through SamplerVoice's own envelope, not adsr, so
+  // the key-up itself is what counts
+  const bool mayFree = isCurrentSoundOneShot || noteReleased;
+  return mayFree && silentSamples >= silenceHoldSamples;
+}
+
 void HowlingVoice::startNote(int midiNoteNumber, float velocity,
                              juce::SynthesiserSound *sound,
                              int currentPitchWheelPosition) {
@@ -114,11 +147,85 @@ void HowlingVoice::startNote(int midiNoteNumber, float velocity,
   isCurrentSoundBass = false;
   isCurrentSoundOneShot = false;
 
+  isGranularNote = false;
+  isStretchNote = false;
+  isWavetableNote = false;
+  isFrozenNote = false;
+  isDirectNote = false;
+  outputBus = 0;
+  noteVelocity = velocity;
+
+  hasSounded = false;
+  silentSamples = 0;
+  noteReleased = false;
+
   if (auto *hs = dynamic_cast<HowlingSound *>(sound)) {
     isCurrentSoundBass = hs->isBassSample();
     isCurrentSoundOneShot = hs->isOneShotSample();
+    isFrozenNote = hs->isFrozenSample();
+    outputBus = routing != nullptr ? routing->getBusFor(*hs) : 0;
+
+    // Sequence loops follow the host tempo once their analysis is ready.
+    // Until then (or with stretch off) they play at their recorded speed.
+    const auto *analysis = hs->getLoopAnalysis();
+
+    if (stretchEnabled && hs->isSequenceSample() && analysis != nullptr &&
+        hs->getAudioData()) {
+      isStretchNote = true;
+      loopBpm = analysis->bpm;
+      stretcher.start(*hs->getAudioData(), hs->getLength(),
+                      hs->getSourceSampleRate() / getSampleRate());
+      stretcher.setSpeed(hostBpm / loopBpm);
+    }
+    // Granular mode is meant for sustained material (Pads/Textures); drums
+    // and FX one-shots (and frozen patches) always play straight.
+    else if (voiceMode == 1 && !isCurrentSoundOneShot && !isFrozenNote &&
+             hs->getAudioData()) {
+      isGranularNote = true;
+      double ratio =
+          std::pow(2.0, (midiNoteNumber - hs->getRootNote()) / 12.0) *
+          hs->getSourceSampleRate() / getSampleRate();
+      granular.start(*hs->getAudioData(), hs->getLength(), ratio);
+    }
+    // Wavetable mode plays the sliced frames at the sample's own pitch,
+    // shifted from its root note like the sample path; no sample reads at
+    // all. Falls back to the sample until the table is built.
+    else if (voiceMode == 2 && !isCurrentSoundOneShot &&
+             hs->getWavetable() != nullptr) {
+      isWavetableNote = true;
+      const auto &table = *hs->getWavetable();
+      wavetableBaseHz =
+          table.cycleHz *
+          std::pow(2.0, (midiNoteNumber - hs->getRootNote()) / 12.0);
+      wavetableOsc.start(table, wavetableBaseHz);
+    }
+    // Plain playback from the host-rate copy once it exists: only the pitch
+    // ratio is left, and the root note is a straight copy
+    else if (!isFrozenNote && hs->getConvertedSample() != nullptr &&
+             hs->getConvertedSample()->sampleRate == getSampleRate()) {
+      isDirectNote = true;
+      directData = &hs->getConvertedSample()->data;
+      directLength = hs->getConvertedSample()->length;
+    }
+    // SamplerVoice keeps its pitch ratio private, so MPE notes on samples
+    // already at the host rate read the sound's own data to be bendable
+    else if (mpeEnabled && !isFrozenNote && hs->getAudioData() != nullptr &&
+             hs->getSourceSampleRate() == getSampleRate()) {
+      isDirectNote = true;
+      directData = hs->getAudioData();
+      directLength = juce::jmin(hs->getLength(), directData->getNumSamples());
+    }
+
+    if (isDirectNote) {
+      directPosition = 0.0;
+      directBaseIncrement =
+          std::pow(2.0, (midiNoteNumber - hs->getRootNote()) / 12.0);
+      directIncrement = directBaseIncrement;
+    }
   }
 
+  resetExpression(currentPitchWheelPosition);
+
   // 1. Base startNote
   juce::SamplerVoice::startNote(midiNoteNumber, velocity, sound,
                                 currentPitchWheelPosition);
@@ -127,10 +234,16 @@ void HowlingVoice::startNote(int midiNoteNumber, float velocity,
 
   adsr.noteOn();
   modAdsr.noteOn(); // Trigger Mod Env
-  filter.reset();
+  voiceFilter.reset();
   lfo.reset();
 }
 
+void HowlingVoice::choke() {
+  // Short enough to read as a cut, long enough not to click
+  adsr.forceRelease(0.005f);
+  modAdsr.forceRelease(0.005f);
+}
+
 void HowlingVoice::stopNote(float velocity, bool allowTailOff) {
   // If One-Shot, IGNORE stopNote (let sample play to end)
   // SamplerVoice naturally stops when sample data runs out (if not looping).
@@ -138,102 +251,280 @@ void HowlingVoice::stopNote(float velocity, bool allowTailOff) {
     return;
   }
 
+  noteReleased = allowTailOff;
+
+  if (isFrozenNote) {
+    juce::SamplerVoice::stopNote(velocity, allowTailOff);
+    return;
+  }
+
   if (allowTailOff) {
     adsr.noteOff();
     modAdsr.noteOff(); // Release Mod Env
     juce::SamplerVoice::stopNote(velocity, true);
   } else {
-    adsr.reset();
-    modAdsr.reset();
+    // juce::Synthesiser stops a stolen voice with (0.0f, false) right before
+    // restarting it: keep the envelope levels so the new attack continues
+    // from there instead of clicking down to zero.
+    if (velocity > 0.0f) {
+      adsr.reset();
+      modAdsr.reset();
+    }
     juce::SamplerVoice::stopNote(velocity, false);
   }
 }
 
-void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
-                                   int startSample, int numSamples) {
-  if (!isVoiceActive())
-    return;
-
-  if (tempBuffer.getNumSamples() < numSamples) {
-    tempBuffer.setSize(1, numSamples, false, false, true);
+void HowlingVoice::setMpe(bool enabled, float bendRangeSemitones) {
+  mpeBendRange = bendRangeSemitones;
+  if (enabled != mpeEnabled) {
+    mpeEnabled = enabled;
+    // Leave no bend or pressure behind when switching off mid-note
+    expression.bendTarget = 0.0f;
+    expression.pressureTarget = 0.0f;
+    expression.timbreTarget = 0.5f;
   }
-  tempBuffer.clear();
-
-  // 1. Render Raw Sample
-  juce::SamplerVoice::renderNextBlock(tempBuffer, 0, numSamples);
+}
 
-  // 2. ADSR
-  adsr.applyEnvelopeToBuffer(tempBuffer, 0, numSamples);
+void HowlingVoice::pitchWheelMoved(int newPitchWheelValue) {
+  if (mpeEnabled)
+    expression.bendTarget =
+        (float)(newPitchWheelValue - 8192) / 8192.0f * mpeBendRange;
+}
 
-  // Calculate Mod Envelope Value (per block implies stepped, per sample is
-  // better) We'll calculate per sample for Filter/Audio targets But for
-  // optimization, let's keep it simple-ish or do per-sample loop.
+void HowlingVoice::controllerMoved(int controllerNumber,
+                                   int newControllerValue) {
+  if (mpeEnabled && controllerNumber == 74)
+    expression.timbreTarget = (float)newControllerValue / 127.0f;
+}
 
-  auto *bufferData = tempBuffer.getWritePointer(0);
+void HowlingVoice::channelPressureChanged(int newChannelPressureValue) {
+  if (mpeEnabled)
+    expression.pressureTarget = (float)newChannelPressureValue / 127.0f;
+}
 
-  // 3. Filter Processing & Mod Env Application
-  for (int i = 0; i < numSamples; ++i) {
-    float lfoValue = lfo.processSample(0.0f);
-    float modEnvVal = modAdsr.getNextSample(); // 0.0 to 1.0 (sustain level etc)
+void HowlingVoice::aftertouchChanged(int newAftertouchValue) {
+  // Polyphonic key pressure: same as channel pressure, for non-MPE
+  // controllers that send it per key
+  if (mpeEnabled)
+    expression.pressureTarget = (float)newAftertouchValue / 127.0f;
+}
 
-    // Calculate effective LFO + Mod modulation
-    // Mod Target 0: Cutoff (Default)
-    // We mix LFO and Mod Env.
+void HowlingVoice::resetExpression(int pitchWheelPosition) {
+  // MPE controllers send the note's initial bend before its note-on;
+  // juce::Synthesiser remembers it per channel and passes it in here.
+  // Pressure and timbre start neutral. No glide into the first values.
+  expression = {};
+  if (mpeEnabled)
+    expression.bendTarget = expression.bend =
+        (float)(pitchWheelPosition - 8192) / 8192.0f * mpeBendRange;
+  expressionMod = 0.0f;
+
+  if (expression.bend != 0.0f)
+    updateExpression(0);
+}
 
-    // Base cutoff modulation from LFO
-    float combinedMod = (lfoValue * lfoDepth);
+void HowlingVoice::updateExpression(int numSamples) {
+  auto &e = expression;
+
+  // ~10 ms one-pole glide, stepped once per block
+  const float coeff =
+      numSamples > 0
+          ? 1.0f - std::exp(-(float)numSamples /
+                            (0.01f * (float)getSampleRate()))
+          : 1.0f;
+  e.bend += (e.bendTarget - e.bend) * coeff;
+  e.pressure += (e.pressureTarget - e.pressure) * coeff;
+  e.timbre += (e.timbreTarget - e.timbre) * coeff;
+
+  // Pressure opens the filter up to an octave, timbre moves it an octave
+  // either way (in the same units as the LFO / Mod Env cutoff mod)
+  expressionMod = e.pressure * 0.5f + (e.timbre - 0.5f);
+
+  // Pitch for the playback paths that own their read rate. Sequence loops
+  // stay tempo-locked; SamplerVoice notes cannot bend (see startNote).
+  const double bendRatio = std::pow(2.0, (double)e.bend / 12.0);
+  if (isDirectNote)
+    directIncrement = directBaseIncrement * bendRatio;
+  else if (isWavetableNote)
+    wavetableOsc.setFrequency(wavetableBaseHz * bendRatio);
+  else if (isGranularNote)
+    granular.setBendRatio(bendRatio);
+}
 
-    // Add Mod Env if Target is Cutoff
-    if (modTarget == 0) {
-      // Mod Amount is 0.0-1.0.
-      // Let's say max amount is +/- 2 octaves or similar.
-      // Or simply scale like LFO.
-      combinedMod += (modEnvVal * modAmount);
+void HowlingVoice::renderDirect(float *dest, int numSamples) {
+  const auto *l = directData->getReadPointer(0);
+  const auto *r = directData->getNumChannels() > 1
+                      ? directData->getReadPointer(1)
+                      : nullptr;
+  const int length = directLength;
+
+  // Mono mix with the velocity gain, as juce::SamplerVoice does
+  const float gain = r != nullptr ? 0.5f * noteVelocity : noteVelocity;
+  int rendered = 0;
+
+  if (directIncrement == 1.0) {
+    // Root note: straight copy
+    const int start = (int)directPosition;
+    rendered = juce::jlimit(0, numSamples, length - start);
+    if (rendered > 0) {
+      juce::FloatVectorOperations::addWithMultiply(dest, l + start, gain,
+                                                   rendered);
+      if (r != nullptr)
+        juce::FloatVectorOperations::addWithMultiply(dest, r + start, gain,
+                                                     rendered);
+      directPosition += rendered;
     }
-
-    float modFactor = std::pow(2.0f, combinedMod * 2.0f); // 2 octaves range
-    float modCutoff = baseCutoff * modFactor;
-    modCutoff = juce::jlimit(20.0f, 20000.0f, modCutoff);
-
-    filter.setCutoffFrequency(modCutoff);
-    filter.setResonance(baseResonance);
-
-    float input = bufferData[i];
-
-    // Apply Mod Env to Vol/Pan/Pitch if selected
-    if (modTarget == 1) { // Volume
-      // Amount determines how much Env affects Vol
-      // If amount 0, no effect. If amount 1, full effect (multiply)
-      // Actually, "Amount" often means "Depth".
-      // Let's simply multiply gain.
-      // input *= (1.0f + (modEnvVal * modAmount)); // This adds gain.
-      // Or subtractive? Standard is Positive Mod adds, Negative (in bipolar)
-      // subtracts. Here modAmount is 0-1 unipolar? Let's assume bipolar range
-      // mapping or just unidirectional. User knob is 0-1. So adds volume.
-      input *= (1.0f - (modAmount * 0.5f) + (modEnvVal * modAmount));
+  } else {
+    for (; rendered < numSamples; ++rendered) {
+      const int pos = (int)directPosition;
+      if (pos >= length - 1)
+        break;
+
+      const float alpha = (float)(directPosition - (double)pos);
+      float s = l[pos] + alpha * (l[pos + 1] - l[pos]);
+      if (r != nullptr)
+        s += r[pos] + alpha * (r[pos + 1] - r[pos]);
+
+      dest[rendered] += s * gain;
+      directPosition += directIncrement;
     }
+  }
 
-    // Pitch (Target 3) would need resampling rate update (expensive inside loop
-    // per sample without interpolator update) Pan (Target 2) handled at end.
+  // End of the sample: same as SamplerVoice, the note ends here
+  if (rendered < numSamples)
+    clearCurrentNote();
+}
 
-    if (std::isnan(input))
-      input = 0.0f;
-    float filtered = filter.processSample(0, input);
+void HowlingVoice::processPatch(float *bufferData, int numSamples) {
+  // 2. ADSR (a single gain while sustaining)
+  adsr.applyTo(bufferData, numSamples);
+
+  if ((int)cutoffBuffer.size() < numSamples)
+    cutoffBuffer.resize((size_t)numSamples);
+  if ((int)modEnvBuffer.size() < numSamples)
+    modEnvBuffer.resize((size_t)numSamples);
+  auto *cutoffData = cutoffBuffer.data();
+  auto *modEnvData = modEnvBuffer.data();
+
+  // Mod Env for the whole block in one pass. Checked before rendering: a
+  // held envelope stays held for the block.
+  const bool modEnvHeld = modAdsr.isConstant();
+  modAdsr.render(modEnvData, numSamples);
+
+  // 3. Modulation: one cutoff per sample, plus the Mod Env volume target
+  if (modEnvHeld && lfoDepth == 0.0f) {
+    // Nothing moves this block: one cutoff and one gain
+    const float modEnvVal = modEnvData[0];
+    const float combinedMod =
+        (modTarget == 0 ? modEnvVal * modAmount : 0.0f) + expressionMod;
+    const float modCutoff = juce::jlimit(
+        20.0f, 20000.0f, baseCutoff * std::pow(2.0f, combinedMod * 2.0f));
+    juce::FloatVectorOperations::fill(cutoffData, modCutoff, numSamples);
+
+    if (modTarget == 1)
+      juce::FloatVectorOperations::multiply(
+          bufferData, 1.0f - (modAmount * 0.5f) + (modEnvVal * modAmount),
+          numSamples);
+  } else {
+    for (int i = 0; i < numSamples; ++i) {
+      float lfoValue = lfo.processSample(0.0f);
+      float modEnvVal = modEnvData[i]; // 0.0 to 1.0 (sustain level etc)
+
+      // Calculate effective LFO + Mod modulation
+      // Mod Target 0: Cutoff (Default)
+      // We mix LFO and Mod Env.
+
+      // Base cutoff modulation from LFO
+      float combinedMod = (lfoValue * lfoDepth) + expressionMod;
+
+      // Add Mod Env if Target is Cutoff
+      if (modTarget == 0) {
+        // Mod Amount is 0.0-1.0.
+        // Let's say max amount is +/- 2 octaves or similar.
+        // Or simply scale like LFO.
+        combinedMod += (modEnvVal * modAmount);
+      }
 
-    if (isNotch) {
-      filtered = input - filtered;
-    }
+      float modFactor = std::pow(2.0f, combinedMod * 2.0f); // 2 octaves range
+      cutoffData[i] = juce::jlimit(20.0f, 20000.0f, baseCutoff * modFactor);
+
+      // Apply Mod Env to Vol/Pan/Pitch if selected
+      if (modTarget == 1) { // Volume
+        // Amount determines how much Env affects Vol
+        // If amount 0, no effect. If amount 1, full effect (multiply)
+        // User knob is 0-1. So adds volume.
+        bufferData[i] *= (1.0f - (modAmount * 0.5f) + (modEnvVal * modAmount));
+      }
+
+      // Pitch (Target 3) would need resampling rate update (expensive inside
+      // loop per sample without interpolator update) Pan (Target 2) handled at
+      // end.
 
-    // Safety Check for NaN/Infinity
-    if (std::isnan(filtered) || std::isinf(filtered)) {
-      filtered = 0.0f;
-      filter.reset();
+      if (std::isnan(bufferData[i]))
+        bufferData[i] = 0.0f;
     }
+  }
+
+  // 4. Filter (drive + oversampling handled inside, see VoiceFilter)
+  voiceFilter.process(bufferData, cutoffData, numSamples);
+}
 
-    bufferData[i] = filtered;
+void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
+                                   int startSample, int numSamples) {
+  if (!isVoiceActive())
+    return;
+
+  if (tempBuffer.getNumSamples() < numSamples) {
+    tempBuffer.setSize(1, numSamples, false, false, true);
   }
+  tempBuffer.clear();
+
+  if (mpeEnabled)
+    updateExpression(numSamples);
+
+  // 1. Render Raw Sample (or the grain cloud / stretched loop)
+  if (isGranularNote) {
+    granular.render(tempBuffer.getWritePointer(0), numSamples);
+    tempBuffer.applyGain(0, 0, numSamples, noteVelocity);
+  } else if (isStretchNote) {
+    stretcher.render(tempBuffer.getWritePointer(0), numSamples);
+    tempBuffer.applyGain(0, 0, numSamples, noteVelocity);
+  } else if (isWavetableNote) {
+    wavetableOsc.render(tempBuffer.getWritePointer(0), numSamples);
+    tempBuffer.applyGain(0, 0, numSamples, noteVelocity);
+  } else if (isDirectNote) {
+    renderDirect(tempBuffer.getWritePointer(0), numSamples);
+  } else {
+    juce::SamplerVoice::renderNextBlock(tempBuffer, 0, numSamples);
+  }
+
+  auto *bufferData = tempBuffer.getWritePointer(0);
 
-  if (!adsr.isActive()) {
+  // The end of the sample cleared the note while rendering: this block
+  // still goes out, but nothing below may clear (or count) it again
+  const bool sampleEnded = getCurrentlyPlayingSound() == nullptr;
+
+  // Frozen patches take the static path: the patch is baked into the sample
+  // and the sampler's own envelope does the release (SamplerVoice clears the
+  // note when it ends).
+  if (!isFrozenNote) {
+    // 2. - 4. Envelopes, modulation, filter
+    processPatch(bufferData, numSamples);
+
+    if (!sampleEnded && !adsr.isActive()) {
+      clearCurrentNote();
+      return;
+    }
+  }
+
+  // Free the voice once its tail has sat below the silence threshold for the
+  // hold time. Only for one-shots and released notes: a held note that goes
+  // quiet (e.g. a slow attack) must keep its slot.
+  if (!sampleEnded && updateSilenceDetector(bufferData, numSamples)) {
+    if (silenceFreedCounter != nullptr)
+      silenceFreedCounter->fetch_add(1, std::memory_order_relaxed);
+    adsr.reset();
+    modAdsr.reset();
     clearCurrentNote();
     return;
   }
@@ -241,12 +532,21 @@ void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
   // FORCE STOP if One-Shot and Sample has finished playing
   // SamplerVoice::isVoiceActive() returns false when sample finishes (if not
   // looping)
-  if (isCurrentSoundOneShot && !juce::SamplerVoice::isVoiceActive()) {
+  if (!sampleEnded && isCurrentSoundOneShot &&
+      !juce::SamplerVoice::isVoiceActive()) {
     clearCurrentNote();
     return;
   }
 
-  // 4. Panning and Output Mix
+  // 5. Panning and Output Mix, straight into the routed bus (main if that
+  //    bus is not in use)
+  auto *busBuffer =
+      outputBus > 0 && routing != nullptr ? routing->buses[(size_t)outputBus]
+                                          : nullptr;
+  auto &output = busBuffer != nullptr && busBuffer->getNumChannels() > 0
+                     ? *busBuffer
+                     : outputBuffer;
+
   if (isCurrentSoundBass) {
     // Bass Logic: Lows (<120Hz) -> Mono, Highs -> Panned
 
@@ -278,10 +578,10 @@ void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
                        -1.0f); // Subtract
 
     // Mix to Output
-    for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch) {
+    for (int ch = 0; ch < output.getNumChannels(); ++ch) {
       // Pan Highs
       float panGain = 1.0f;
-      if (outputBuffer.getNumChannels() == 2) {
+      if (output.getNumChannels() == 2) {
         float panRad = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
         if (ch == 0)
           panGain = std::cos(panRad);
@@ -296,21 +596,21 @@ void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
       // want full power. Let's stick to standard pan center gain approx 0.707
       // if we want consistency with other sounds. But typically "Mono" means
       // equal in both.
-      bassGain = (outputBuffer.getNumChannels() == 2) ? 0.707f : 1.0f;
+      bassGain = (output.getNumChannels() == 2) ? 0.707f : 1.0f;
 
       // Add Lows (Center)
-      outputBuffer.addFrom(ch, startSample, tempBuffer, 0, 0, numSamples,
+      output.addFrom(ch, startSample, tempBuffer, 0, 0, numSamples,
                            bassGain);
 
       // Add Highs (Panned)
-      outputBuffer.addFrom(ch, startSample, highBuffer, 0, 0, numSamples,
+      output.addFrom(ch, startSample, highBuffer, 0, 0, numSamples,
                            panGain);
     }
   } else {
     // Standard processing
-    for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch) {
+    for (int ch = 0; ch < output.getNumChannels(); ++ch) {
       float gain = 1.0f;
-      if (outputBuffer.getNumChannels() == 2) {
+      if (output.getNumChannels() == 2) {
         float panRad = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
         if (ch == 0)
           gain = std::cos(panRad);
@@ -318,7 +618,7 @@ void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
           gain = std::sin(panRad);
       }
 
-      outputBuffer.addFrom(ch, startSample, tempBuffer, 0, 0, numSamples, gain);
+      output.addFrom(ch, startSample, tempBuffer, 0, 0, numSamples, gain);
     }
   }
 }
@@ -330,8 +630,14 @@ void HowlingVoice::renderNextBlock(juce::AudioBuffer<float> &outputBuffer,
 SynthEngine::SynthEngine() {
   // Add voices
   for (int i = 0; i < 8; ++i) {
-    addVoice(new HowlingVoice());
+    auto *voice = new HowlingVoice();
+    voice->setSilenceFreedCounter(&voicesFreedBySilence);
+    voice->setOutputRouting(&outputRouting);
+    addVoice(voice);
   }
+
+  jassert(getNumVoices() <= (int)voiceSound.size()); // Voice bitmasks
+  voicePadNote.fill(-1);
 }
 
 void SynthEngine::initialize() {
@@ -379,12 +685,180 @@ void SynthEngine::updateModParams(float attack, float decay, float sustain,
   }
 }
 
+void SynthEngine::setSilenceDetection(float thresholdDb, float holdMs) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setSilenceDetection(thresholdDb, holdMs);
+    }
+  }
+}
+
+void SynthEngine::setEnvelopeCurve(float curve) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setEnvelopeCurve(curve);
+    }
+  }
+}
+
+void SynthEngine::updateFilterDrive(float drive, int quality) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->updateFilterDrive(drive, quality);
+    }
+  }
+}
+
+void SynthEngine::setVoiceMode(int mode) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setVoiceMode(mode);
+    }
+  }
+}
+
+void SynthEngine::updateGranularParams(
+    const GranularEngine::Parameters &params) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->updateGranularParams(params);
+    }
+  }
+}
+
+void SynthEngine::setWavetablePosition(float position) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setWavetablePosition(position);
+    }
+  }
+}
+
+void SynthEngine::setStretchEnabled(bool enabled) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setStretchEnabled(enabled);
+    }
+  }
+}
+
+void SynthEngine::setHostBpm(double bpm) {
+  if (bpm <= 0.0)
+    return;
+
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setHostBpm(bpm);
+    }
+  }
+}
+
 void SynthEngine::setPackMode(int size, float spread) {
   packSize = size;
   packSpread = spread;
 }
 
+void SynthEngine::setMpe(bool enabled, float bendRangeSemitones) {
+  for (int i = 0; i < getNumVoices(); ++i) {
+    if (auto *voice = dynamic_cast<HowlingVoice *>(getVoice(i))) {
+      voice->setMpe(enabled, bendRangeSemitones);
+    }
+  }
+}
+
+void SynthEngine::setAuxBus(int bus, juce::AudioBuffer<float> *buffer) {
+  if (bus >= 1 && bus <= OutputRouting::maxAuxBuses)
+    outputRouting.buses[(size_t)bus] = buffer;
+}
+
+void SynthEngine::setPadOutput(int pad, int bus) {
+  if (pad >= 0 && pad < OutputRouting::numPads)
+    outputRouting.padBus[(size_t)pad] =
+        juce::jlimit(0, OutputRouting::maxAuxBuses, bus);
+}
+
+void SynthEngine::setLayerOutput(int layer, int bus) {
+  if (layer >= 0 && layer < OutputRouting::numLayers)
+    outputRouting.layerBus[(size_t)layer] =
+        juce::jlimit(0, OutputRouting::maxAuxBuses, bus);
+}
+
+juce::SynthesiserSound *
+SynthEngine::addSound(const juce::SynthesiserSound::Ptr &sound) {
+  const juce::ScopedLock sl(lock);
+  auto *added = juce::Synthesiser::addSound(sound);
+  rebuildSoundIndex();
+  return added;
+}
+
+void SynthEngine::removeSound(int index) {
+  const juce::ScopedLock sl(lock);
+  juce::Synthesiser::removeSound(index);
+  rebuildSoundIndex();
+}
+
+void SynthEngine::clearSounds() {
+  const juce::ScopedLock sl(lock);
+  juce::Synthesiser::clearSounds();
+  rebuildSoundIndex();
+}
+
+void SynthEngine::rebuildSoundIndex() {
+  padSoundForNote.fill(nullptr);
+  hasVelocityLayers = false;
+
+  for (auto *sound : sounds) {
+    auto *hs = dynamic_cast<HowlingSound *>(sound);
+    if (hs == nullptr)
+      continue;
+
+    hasVelocityLayers = hasVelocityLayers || hs->hasVelocityRange();
+
+    // First pad wins, as it did when note-on searched the list
+    if (hs->hasPadSettings())
+      for (int note = 0; note < (int)padSoundForNote.size(); ++note)
+        if (padSoundForNote[(size_t)note] == nullptr &&
+            hs->appliesToNote(note))
+          padSoundForNote[(size_t)note] = hs;
+  }
+}
+
 void SynthEngine::noteOn(int midiChannel, int midiNoteNumber, float velocity) {
+  // Drum pads with choke / voice rules take their own path
+  {
+    const juce::ScopedLock sl(lock);
+
+    if (midiNoteNumber >= 0 && midiNoteNumber < (int)padSoundForNote.size()) {
+      auto *hs = padSoundForNote[(size_t)midiNoteNumber];
+      if (hs != nullptr && hs->appliesToChannel(midiChannel)) {
+        startPadNote(hs, midiChannel, midiNoteNumber, velocity);
+        return;
+      }
+    }
+
+    // Velocity-layered zones (frozen patches): only the matching layer plays
+    if (hasVelocityLayers) {
+      for (auto *sound : sounds) {
+        auto *hs = dynamic_cast<HowlingSound *>(sound);
+        if (hs == nullptr || !hs->appliesToNote(midiNoteNumber) ||
+            !hs->appliesToChannel(midiChannel) ||
+            !hs->appliesToVelocity(velocity))
+          continue;
+
+        // Same retrigger rule as juce::Synthesiser::noteOn
+        for (auto *voice : voices)
+          if (voice->getCurrentlyPlayingNote() == midiNoteNumber &&
+              voice->isPlayingChannel(midiChannel))
+            stopVoice(voice, 1.0f, true);
+
+        startVoice(findFreeVoice(sound, midiChannel, midiNoteNumber,
+                                 isNoteStealingEnabled()),
+                   sound, midiChannel, midiNoteNumber, velocity);
+      }
+      return;
+    }
+  }
+
   // Standard note on
   // If Unison is active (packSize > 1), trigger multiple voices
 
@@ -399,3 +873,136 @@ void SynthEngine::noteOn(int midiChannel, int midiNoteNumber, float velocity) {
     juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
   }
 }
+
+namespace {
+int lowestSetBit(juce::uint32 bits) {
+  return juce::findHighestSetBit(bits & (~bits + 1));
+}
+} // namespace
+
+juce::uint32 SynthEngine::getLiveVoices(juce::uint32 mask) const {
+  // Drop voices that have finished or moved on to another sound since they
+  // were registered
+  for (auto bits = mask; bits != 0; bits &= bits - 1) {
+    const int i = lowestSetBit(bits);
+    auto playing = voices[i]->getCurrentlyPlayingSound();
+    if (playing == nullptr || playing.get() != voiceSound[(size_t)i])
+      mask &= ~(1u << i);
+  }
+  return mask;
+}
+
+bool SynthEngine::isReservedVoice(int voiceIndex) const {
+  const int note = voicePadNote[(size_t)voiceIndex];
+  if (note < 0)
+    return false;
+
+  // Only trust voiceSound while the voice still holds that sound
+  const auto live = getLiveVoices(padVoices[(size_t)note]);
+  if ((live & (1u << voiceIndex)) == 0)
+    return false;
+
+  const auto *hs = dynamic_cast<const HowlingSound *>(
+      voiceSound[(size_t)voiceIndex]);
+  if (hs == nullptr)
+    return false;
+
+  return juce::countNumberOfBits(live) <= hs->getPadSettings().reservedVoices;
+}
+
+juce::SynthesiserVoice *
+SynthEngine::findVoiceToSteal(juce::SynthesiserSound *sound, int midiChannel,
+                              int midiNoteNumber) const {
+  juce::SynthesiserVoice *oldest = nullptr;
+  bool anyReserved = false;
+
+  for (int i = 0; i < voices.size(); ++i) {
+    auto *voice = voices.getUnchecked(i);
+
+    if (isReservedVoice(i)) {
+      anyReserved = true;
+      continue;
+    }
+
+    if (voice->canPlaySound(sound) &&
+        (oldest == nullptr || voice->wasStartedBefore(*oldest)))
+      oldest = voice;
+  }
+
+  // Without reservations keep JUCE's stealing (protects top/bottom notes)
+  if (!anyReserved)
+    return juce::Synthesiser::findVoiceToSteal(sound, midiChannel,
+                                               midiNoteNumber);
+  if (oldest != nullptr)
+    return oldest;
+
+  // Every voice is reserved: a pad may still recycle its own oldest voice,
+  // anything else drops the note rather than break a reservation
+  if (midiNoteNumber < 0 || midiNoteNumber >= (int)padVoices.size())
+    return nullptr;
+
+  const auto own = getLiveVoices(padVoices[(size_t)midiNoteNumber]);
+  for (auto bits = own; bits != 0; bits &= bits - 1) {
+    auto *voice = voices.getUnchecked(lowestSetBit(bits));
+    if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+      oldest = voice;
+  }
+  return oldest;
+}
+
+void SynthEngine::startPadNote(HowlingSound *sound, int midiChannel,
+                               int midiNoteNumber, float velocity) {
+  const auto &pad = sound->getPadSettings();
+  auto &thisPad = padVoices[(size_t)midiNoteNumber];
+  thisPad = getLiveVoices(thisPad);
+
+  // 1. Choke group: cut every other pad's voices in the same group
+  const int group = juce::jlimit(0, maxChokeGroups, pad.chokeGroup);
+  if (group > 0) {
+    auto &groupVoices = chokeGroupVoices[(size_t)group];
+    groupVoices = getLiveVoices(groupVoices);
+
+    for (auto bits = groupVoices & ~thisPad; bits != 0; bits &= bits - 1) {
+      const int i = lowestSetBit(bits);
+      if (auto *voice = dynamic_cast<HowlingVoice *>(voices[i]))
+        voice->choke();
+    }
+  }
+
+  // 2. Pick a voice: the pad's own oldest once it is at its limit, else a
+  //    free one, else a steal that respects other pads' reservations
+  juce::SynthesiserVoice *voice = nullptr;
+
+  if (pad.maxVoices > 0 && juce::countNumberOfBits(thisPad) >= pad.maxVoices) {
+    for (auto bits = thisPad; bits != 0; bits &= bits - 1) {
+      auto *candidate = voices[lowestSetBit(bits)];
+      if (voice == nullptr || candidate->wasStartedBefore(*voice))
+        voice = candidate;
+    }
+  }
+
+  if (voice == nullptr)
+    voice = findFreeVoice(sound, midiChannel, midiNoteNumber,
+                          isNoteStealingEnabled());
+
+  if (voice == nullptr)
+    return;
+
+  startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+
+  // 3. Re-register the voice under this pad / group
+  const int index = voices.indexOf(voice);
+  if (index < 0 || index >= (int)voiceSound.size())
+    return;
+
+  const juce::uint32 bit = 1u << index;
+  if (voicePadNote[(size_t)index] >= 0)
+    padVoices[(size_t)voicePadNote[(size_t)index]] &= ~bit;
+  chokeGroupVoices[(size_t)voiceChokeGroup[(size_t)index]] &= ~bit;
+
+  voiceSound[(size_t)index] = sound;
+  voicePadNote[(size_t)index] = midiNoteNumber;
+  voiceChokeGroup[(size_t)index] = group;
+  thisPad |= bit;
+  chokeGroupVoices[(size_t)group] |= bit;
+}
@@ -1,6 +1,16 @@
 #pragma once
 
+#include "EnvelopeGenerator.h"
+#include "GranularEngine.h"
+#include "SampleRateConverter.h"
+#include "TimeStretcher.h"
+#include "VoiceFilter.h"
+#include "WavetableEngine.h"
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 //==============================================================================
 /**
@@ -14,18 +24,154 @@ public:
                const juce::BigInteger &midiNotes, int midiNoteForNormalPitch,
                double attackTimeSecs, double releaseTimeSecs,
                double maxSampleLengthSeconds, bool isBassSound = false,
-               bool isOneShotSound = false)
+               bool isOneShotSound = false, bool isSequenceSound = false)
       : juce::SamplerSound(name, source, midiNotes, midiNoteForNormalPitch,
                            attackTimeSecs, releaseTimeSecs,
                            maxSampleLengthSeconds),
-        isBass(isBassSound), isOneShot(isOneShotSound) {}
+        isBass(isBassSound), isOneShot(isOneShotSound),
+        isSequence(isSequenceSound),
+        rootNote(midiNoteForNormalPitch), sourceSampleRate(source.sampleRate),
+        length((int)juce::jmin((juce::int64)source.lengthInSamples,
+                               (juce::int64)(maxSampleLengthSeconds *
+                                             source.sampleRate))) {}
 
   bool isBassSample() const { return isBass; }
   bool isOneShotSample() const { return isOneShot; }
+  bool isSequenceSample() const { return isSequence; }
+
+  // juce::SamplerSound keeps these private, but custom playback modes
+  // (granular) need them to read getAudioData() directly.
+  int getRootNote() const { return rootNote; }
+  double getSourceSampleRate() const { return sourceSampleRate; }
+  int getLength() const { return length; }
+
+  // Tempo analysis for Sequence loops. Filled in by SampleManager's worker
+  // pool; nullptr until the analysis has finished. The pointed-to analysis is
+  // owned by SampleManager's cache.
+  void setLoopAnalysis(const LoopAnalysis *analysis) {
+    loopAnalysis.store(analysis);
+  }
+  const LoopAnalysis *getLoopAnalysis() const { return loopAnalysis.load(); }
+
+  // Single-cycle frames for Wavetable mode, built in the background the same
+  // way (owned by SampleManager's cache, nullptr until ready).
+  void setWavetable(const Wavetable *table) { wavetable.store(table); }
+  const Wavetable *getWavetable() const { return wavetable.load(); }
+
+  // The sample resampled to the host rate (SampleManager's worker pool,
+  // shared with its cache). nullptr while converting or when the rates
+  // match. Only one conversion is held: replacing it releases the previous
+  // one, so SampleManager swaps it only while no voice can be reading it
+  // (after a rate change has stopped every voice, or for the same data).
+  void setConvertedSample(std::shared_ptr<const ConvertedSample> sample) {
+    convertedSample.store(sample.get());
+    convertedSampleOwner = std::move(sample);
+  }
+  const ConvertedSample *getConvertedSample() const {
+    return convertedSample.load();
+  }
+
+  // Keeps the cached analysis / wavetable behind the pointers above alive for
+  // as long as the sound (and any voice still playing it) lives, so
+  // SampleManager can evict its cache entries freely. Called under
+  // SampleManager's cache lock.
+  void retainCachedData(std::shared_ptr<const void> data) {
+    if (data != nullptr &&
+        std::find(retainedData.begin(), retainedData.end(), data) ==
+            retainedData.end())
+      retainedData.push_back(std::move(data));
+  }
+
+  // File the sound was loaded from (for re-conversion on a rate change)
+  void setSourceFile(const juce::File &file) { sourceFile = file; }
+  const juce::File &getSourceFile() const { return sourceFile; }
+
+  // Drum pad voice rules (see SynthEngine::noteOn). Set before the sound is
+  // added to the synth.
+  struct PadSettings {
+    int chokeGroup = 0;     // 0 = none, pads sharing a group cut each other
+    int maxVoices = 0;      // 0 = unlimited, else the pad recycles its oldest
+    int reservedVoices = 0; // Voices other pads may not steal from this one
+  };
+  void setPadSettings(const PadSettings &settings) { padSettings = settings; }
+  const PadSettings &getPadSettings() const { return padSettings; }
+  bool hasPadSettings() const {
+    return padSettings.chokeGroup > 0 || padSettings.maxVoices > 0 ||
+           padSettings.reservedVoices > 0;
+  }
+
+  // Velocity layers (frozen patches). The default covers every velocity.
+  void setVelocityRange(float low, float high) {
+    velocityLow = low;
+    velocityHigh = high;
+  }
+  bool appliesToVelocity(float velocity) const {
+    return (velocity > velocityLow || velocityLow <= 0.0f) &&
+           velocity <= velocityHigh;
+  }
+  bool hasVelocityRange() const {
+    return velocityLow > 0.0f || velocityHigh < 1.0f;
+  }
+
+  // Rendered by PatchFreezer: the patch is already baked in, so voices play it
+  // on the static path (no envelopes / modulation / filter).
+  void setFrozen(bool frozen) { isFrozen = frozen; }
+  bool isFrozenSample() const { return isFrozen; }
+
+  // Multi-out routing keys: drum pad slot (loadDrumKit order, -1 = not a pad)
+  // and velocity layer (frozen zones; a plain sound is layer 0)
+  void setPadIndex(int index) { padIndex = index; }
+  int getPadIndex() const { return padIndex; }
+  void setLayerIndex(int index) { layerIndex = index; }
+  int getLayerIndex() const { return layerIndex; }
 
 private:
   bool isBass;
   bool isOneShot;
+  bool isSequence;
+  std::atomic<const LoopAnalysis *> loopAnalysis{nullptr};
+  std::atomic<const Wavetable *> wavetable{nullptr};
+  PadSettings padSettings;
+  std::atomic<const ConvertedSample *> convertedSample{nullptr};
+  std::shared_ptr<const ConvertedSample> convertedSampleOwner;
+  std::vector<std::shared_ptr<const void>> retainedData;
+  juce::File sourceFile;
+  float velocityLow = 0.0f;
+  float velocityHigh = 1.0f;
+  bool isFrozen = false;
+  int padIndex = -1;
+  int layerIndex = 0;
+  int rootNote;
+  double sourceSampleRate;
+  int length;
+};
+
+//==============================================================================
+/**
+    Multi-out routing, owned by SynthEngine and read by its voices.
+
+    Bus 0 is the buffer the synth renders into (main output). Aux buses are
+    aliases of the host's bus channels set before each render; a voice routed
+    to a bus that is not in use plays on the main output instead.
+*/
+struct OutputRouting {
+  static constexpr int maxAuxBuses = 8;
+  static constexpr int numPads = 16;
+  static constexpr int numLayers = 8;
+
+  // [0] unused (main), [1..maxAuxBuses] = aux bus or nullptr when disabled
+  std::array<juce::AudioBuffer<float> *, maxAuxBuses + 1> buses{};
+  std::array<int, numPads> padBus{};
+  std::array<int, numLayers> layerBus{};
+
+  int getBusFor(const HowlingSound &sound) const {
+    const int pad = sound.getPadIndex();
+    if (pad >= 0)
+      return pad < numPads ? padBus[(size_t)pad] : 0;
+
+    const int layer = juce::jlimit(0, numLayers - 1, sound.getLayerIndex());
+    return layerBus[(size_t)layer];
+  }
 };
 
 //==============================================================================
@@ -44,6 +190,8 @@ public:
 
   // DSP Parameters
   void updateFilter(float cutoff, float resonance, int filterType);
+  // Drive 0.0 - 1.0; quality 0 = Eco, 1 = Standard (2x), 2 = High (4x)
+  void updateFilterDrive(float drive, int quality);
   void updateLFO(float rate, float depth);
   void prepare(double sampleRate, int samplesPerBlock);
 
@@ -62,17 +210,57 @@ public:
   void renderNextBlock(juce::AudioBuffer<float> &outputBuffer, int startSample,
                        int numSamples) override;
 
+  // Envelopes, modulation and filter (everything a frozen patch skips)
+  void processPatch(float *data, int numSamples);
+
   // Custom ADSR access
   void updateADSR(float attack, float decay, float sustain, float release);
+  // 0.0 = linear segments, 1.0 = exponential (both envelopes)
+  void setEnvelopeCurve(float curve);
+
+  // Playback mode: 0 = Sample, 1 = Granular, 2 = Wavetable. Takes effect on
+  // the next note.
+  void setVoiceMode(int newMode) { voiceMode = newMode; }
+  void updateGranularParams(const GranularEngine::Parameters &params);
+  void setWavetablePosition(float position);
+
+  // Tempo-matched playback of Sequence loops
+  void setStretchEnabled(bool enabled) { stretchEnabled = enabled; }
+  void setHostBpm(double bpm);
+
+  // Ends one-shots / released notes early once they stay below thresholdDb
+  // for holdMs. The counter (owned by SynthEngine) counts voices freed so.
+  void setSilenceDetection(float thresholdDb, float holdMs);
+  void setSilenceFreedCounter(std::atomic<int> *counter) {
+    silenceFreedCounter = counter;
+  }
+
+  // Fast fade-out when another pad in the same choke group is hit
+  void choke();
+
+  // Multi-out: the bus is picked from the routing on each note-on
+  void setOutputRouting(const OutputRouting *newRouting) {
+    routing = newRouting;
+  }
+
+  // MPE: per-note pitch bend (bendRange semitones either way), pressure and
+  // CC74 timbre. juce::Synthesiser only hands a voice the messages of the
+  // channel its note is playing on, so with one note per channel these are
+  // per-note. Ignored while MPE is off.
+  void setMpe(bool enabled, float bendRangeSemitones);
+  void pitchWheelMoved(int newPitchWheelValue) override;
+  void controllerMoved(int controllerNumber, int newControllerValue) override;
+  void channelPressureChanged(int newChannelPressureValue) override;
+  void aftertouchChanged(int newAftertouchValue) override;
 
 private:
-  juce::dsp::StateVariableTPTFilter<float> filter;
+  VoiceFilter voiceFilter;
   juce::dsp::Oscillator<float> lfo; // For filter modulation
   float lfoDepth = 0.0f;
   float pan = 0.0f; // -1.0 (Left) to 1.0 (Right)
 
-  juce::ADSR adsr;
-  juce::ADSR::Parameters adsrParams;
+  EnvelopeGenerator adsr;
+  EnvelopeGenerator::Parameters adsrParams;
   float lfoRate = 0.0f;
 
   // Sample Parameters
@@ -82,8 +270,9 @@ private:
   bool isLooping = true;
 
   // Modulation Envelope
-  juce::ADSR modAdsr;
-  juce::ADSR::Parameters modAdsrParams;
+  EnvelopeGenerator modAdsr;
+  EnvelopeGenerator::Parameters modAdsrParams;
+  std::vector<float> modEnvBuffer; // Mod Env rendered per block
   float modAmount = 0.5f;
   int modTarget = 0; // 0=None/Filter, 1=Vol, 2=Pan, 3=Pitch
 
@@ -98,12 +287,72 @@ public: // Accessor needed for setup
   // One-Shot processing
   bool isCurrentSoundOneShot = false;
 
+  // Granular processing (Pads / Textures)
+  GranularEngine granular;
+  int voiceMode = 0;
+  bool isGranularNote = false;
+  float noteVelocity = 1.0f;
+
+  // Time-stretch processing (Sequences)
+  TimeStretcher stretcher;
+  bool stretchEnabled = false;
+  bool isStretchNote = false;
+  double hostBpm = 120.0;
+  double loopBpm = 120.0;
+
+  // Wavetable processing (sustained Leads / Pads)
+  WavetableOscillator wavetableOsc;
+  bool isWavetableNote = false;
+
+  // Frozen patch playback (static path)
+  bool isFrozenNote = false;
+
+  // Host-rate sample playback (replaces SamplerVoice's double resampling)
+  void renderDirect(float *dest, int numSamples);
+  const juce::AudioBuffer<float> *directData = nullptr;
+  int directLength = 0;
+  double directPosition = 0.0;
+  double directIncrement = 1.0;
+  double directBaseIncrement = 1.0; // Without the MPE bend
+  bool isDirectNote = false;
+
+  // MPE expression. The MIDI callbacks only store targets here; the voice
+  // glides towards them once per block (control rate), so a dense stream of
+  // expression messages costs nothing extra per sample.
+  struct NoteExpression {
+    float bendTarget = 0.0f;     // Semitones
+    float pressureTarget = 0.0f; // 0.0 - 1.0
+    float timbreTarget = 0.5f;   // 0.0 - 1.0 (CC74, 64 = centre)
+    float bend = 0.0f;
+    float pressure = 0.0f;
+    float timbre = 0.5f;
+  };
+  void resetExpression(int pitchWheelPosition);
+  void updateExpression(int numSamples);
+  NoteExpression expression;
+  bool mpeEnabled = false;
+  float mpeBendRange = 48.0f;
+  float expressionMod = 0.0f; // Pressure + timbre, added to the cutoff mod
+  double wavetableBaseHz = 440.0;
+
+  // Silence detection (early voice release)
+  bool updateSilenceDetector(const float *data, int numSamples);
+  float silenceThreshold = 3.16e-5f; // -90 dB
+  int silenceHoldSamples = 2205;     // 50 ms @ 44.1k
+  int silentSamples = 0;
+  bool hasSounded = false;
+  bool noteReleased = false; // Key up with tail-off, whichever envelope runs
+  std::atomic<int> *silenceFreedCounter = nullptr;
+
+  // Multi-out
+  const OutputRouting *routing = nullptr;
+  int outputBus = 0;
+
   // Base parameters for modulation
   float baseCutoff = 20000.0f;
-  float baseResonance = 0.1f;
-  bool isNotch = false;
 
   juce::AudioBuffer<float> tempBuffer;
+  std::vector<float> cutoffBuffer; // Per-sample modulated cutoff
 
   JUCE_LEAK_DETECTOR(HowlingVoice)
 };
@@ -130,12 +379,80 @@ public:
   void updateSampleParams(float tune, float sampleStart, float sampleEnd,
                           bool loop);
 
+  // Early voice release on silent tails
+  void setSilenceDetection(float thresholdDb, float holdMs);
+  int getNumVoicesFreedBySilence() const {
+    return voicesFreedBySilence.load(std::memory_order_relaxed);
+  }
+  void resetVoicesFreedBySilence() { voicesFreedBySilence.store(0); }
+
+  // Envelope segment shape, 0.0 (linear) - 1.0 (exponential)
+  void setEnvelopeCurve(float curve);
+
+  // Voice filter drive and oversampling quality
+  void updateFilterDrive(float drive, int quality);
+
+  // Playback mode (Sample / Granular / Wavetable) and their controls
+  void setVoiceMode(int mode);
+  void updateGranularParams(const GranularEngine::Parameters &params);
+  void setWavetablePosition(float position);
+
+  // Sequence time-stretch: follows the host tempo without changing pitch
+  void setStretchEnabled(bool enabled);
+  void setHostBpm(double bpm);
+
   // Unison (Pack Mode) parameters
   void setPackMode(int size, float spread); // size 1-8, spread 0.0-1.0
 
+  // MPE: one note per MIDI channel with per-note bend, pressure and timbre
+  void setMpe(bool enabled, float bendRangeSemitones);
+
+  // Multi-out. setAuxBus() points aux bus 1..maxAuxBuses at the host's bus
+  // channels for the next render (nullptr = not in use). Pads and layers are
+  // routed to a bus (0 = main); the routing applies from the next note.
+  void setAuxBus(int bus, juce::AudioBuffer<float> *buffer);
+  void setPadOutput(int pad, int bus);
+  void setLayerOutput(int layer, int bus);
+
+  // Sound list changes also rebuild the note-on index below. These hide the
+  // juce::Synthesiser versions, so always change the sounds through here.
+  juce::SynthesiserSound *addSound(const juce::SynthesiserSound::Ptr &sound);
+  void removeSound(int index);
+  void clearSounds();
+
   void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
 
+protected:
+  // Honours the pads' reserved voices; otherwise the default JUCE choice
+  juce::SynthesiserVoice *findVoiceToSteal(juce::SynthesiserSound *sound,
+                                           int midiChannel,
+                                           int midiNoteNumber) const override;
+
 private:
+  // Drum pads with choke groups / voice limits. Each pad and each choke group
+  // keeps a bitmask of the voices it started, so note-on only ever looks at
+  // the handful of voices involved rather than walking the whole pool.
+  static constexpr int maxChokeGroups = 16;
+  void startPadNote(HowlingSound *sound, int midiChannel, int midiNoteNumber,
+                    float velocity);
+  juce::uint32 getLiveVoices(juce::uint32 mask) const;
+  bool isReservedVoice(int voiceIndex) const;
+
+  // Note-on lookups, rebuilt (under the lock) whenever the sounds change:
+  // the pad with voice rules on each note, and whether any velocity layers
+  // are loaded
+  void rebuildSoundIndex();
+  std::array<HowlingSound *, 128> padSoundForNote{};
+  bool hasVelocityLayers = false;
+
+  std::array<juce::uint32, 128> padVoices{};
+  std::array<juce::uint32, maxChokeGroups + 1> chokeGroupVoices{};
+  std::array<const juce::SynthesiserSound *, 32> voiceSound{};
+  std::array<int, 32> voicePadNote{};
+  std::array<int, 32> voiceChokeGroup{};
+
+  std::atomic<int> voicesFreedBySilence{0};
+  OutputRouting outputRouting;
   int packSize = 1;
   float packSpread = 0.0f; // Detune and Pan spread amount
 };
@@ -0,0 +1,248 @@
+#include "TimeStretcher.h"
+
+//==============================================================================
+// LoopAnalysis
+//==============================================================================
+
+LoopAnalysis LoopAnalysis::analyse(const juce::AudioBuffer<float> &data,
+                                   int length, double sampleRate) {
+  LoopAnalysis result;
+  length = juce::jmin(length, data.getNumSamples());
+
+  if (length <= 0 || sampleRate <= 0.0)
+    return result;
+
+  // 1. Onset strength: positive log-energy flux per analysis frame
+  const int hop = 512;
+  const int numFrames = length / hop;
+  const auto *l = data.getReadPointer(0);
+  const auto *r = data.getNumChannels() > 1 ? data.getReadPointer(1) : l;
+
+  std::vector<float> onset((size_t)juce::jmax(numFrames, 1), 0.0f);
+  float previousEnergy = 0.0f;
+
+  for (int f = 0; f < numFrames; ++f) {
+    float energy = 0.0f;
+    for (int i = f * hop; i < (f + 1) * hop; ++i) {
+      float s = 0.5f * (l[i] + r[i]);
+      energy += s * s;
+    }
+    energy = std::log(energy + 1.0e-6f);
+    if (f > 0)
+      onset[(size_t)f] = juce::jmax(0.0f, energy - previousEnergy);
+    previousEnergy = energy;
+  }
+
+  // 2. Autocorrelation over 60..200 BPM
+  const double framesPerSecond = sampleRate / (double)hop;
+  const int minLag = juce::jmax(1, (int)(framesPerSecond * 60.0 / 200.0));
+  const int maxLag = juce::jmin(numFrames - 1, (int)framesPerSecond);
+
+  double estimate = 120.0;
+  float bestScore = 0.0f;
+
+  for (int lag = minLag; lag <= maxLag; ++lag) {
+    float score = 0.0f;
+    for (int f = lag; f < numFrames; ++f)
+      score += onset[(size_t)f] * onset[(size_t)(f - lag)];
+    score /= (float)(numFrames - lag);
+
+    if (score > bestScore) {
+      bestScore = score;
+      estimate = 60.0 * framesPerSecond / (double)lag;
+    }
+  }
+
+  // 3. Loops are cut on the beat: snap to a whole number of beats
+  const double loopSeconds = (double)length / sampleRate;
+  result.numBeats =
+      juce::jmax(1, juce::roundToInt(loopSeconds * estimate / 60.0));
+  result.bpm = 60.0 * (double)result.numBeats / loopSeconds;
+
+  while (result.bpm < 70.0 && result.numBeats < 256) {
+    result.numBeats *= 2;
+    result.bpm *= 2.0;
+  }
+  while (result.bpm > 180.0 && result.numBeats % 2 == 0) {
+    result.numBeats /= 2;
+    result.bpm *= 0.5;
+  }
+
+  // 4. Beat markers on the grid, nudged to the strongest nearby onset
+  result.beatPositions.reserve((size_t)result.numBeats);
+  const double samplesPerBeat = (double)length / (double)result.numBeats;
+
+  for (int b = 0; b < result.numBeats; ++b) {
+    int gridFrame = juce::jlimit(0, juce::jmax(0, numFrames - 1),
+                                 (int)((double)b * samplesPerBeat / hop));
+    int bestFrame = gridFrame;
+
+    for (int f = juce::jmax(1, gridFrame - 2);
+         f <= juce::jmin(numFrames - 1, gridFrame + 2); ++f) {
+      if (onset[(size_t)f] > onset[(size_t)bestFrame])
+        bestFrame = f;
+    }
+
+    result.beatPositions.push_back(b == 0 ? 0 : bestFrame * hop);
+  }
+
+  return result;
+}
+
+//==============================================================================
+// TimeStretcher
+//==============================================================================
+
+TimeStretcher::TimeStretcher() { prepare(44100.0); }
+
+void TimeStretcher::prepare(double sampleRate) {
+  // ~23 ms frames regardless of the host rate
+  frameSize = juce::nextPowerOfTwo((int)(sampleRate * 0.023));
+  hopSize = frameSize / 2;
+  tolerance = frameSize / 4;
+
+  // Periodic Hann sums to unity at 50% overlap
+  window.resize((size_t)frameSize);
+  for (int i = 0; i < frameSize; ++i)
+    window[(size_t)i] =
+        0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float)i /
+                               (float)frameSize);
+
+  frame.assign((size_t)(frameSize + 2 * tolerance), 0.0f);
+  continuation.assign((size_t)(frameSize - hopSize), 0.0f);
+  overlapAdd.assign((size_t)frameSize, 0.0f);
+  ready.assign((size_t)hopSize, 0.0f);
+
+  reset();
+}
+
+void TimeStretcher::reset() {
+  std::fill(overlapAdd.begin(), overlapAdd.end(), 0.0f);
+  readyPosition = hopSize; // Forces a new hop on the first render
+  hasContinuation = false;
+  nominalPosition = 0.0;
+}
+
+void TimeStretcher::start(const juce::AudioBuffer<float> &source,
+                          int sourceLength, double resampleRatio,
+                          int startPosition) {
+  reset();
+
+  sourceL = source.getReadPointer(0);
+  sourceR = source.getNumChannels() > 1 ? source.getReadPointer(1) : nullptr;
+  loopLength = juce::jmin(sourceLength, source.getNumSamples());
+  resample = resampleRatio;
+  nominalPosition = (double)startPosition;
+}
+
+float TimeStretcher::readSource(double position) const {
+  const double len = (double)loopLength;
+  position = std::fmod(position, len);
+  if (position < 0.0)
+    position += len;
+
+  const int i0 = (int)position;
+  const int i1 = (i0 + 1) % loopLength;
+  const float frac = (float)(position - (double)i0);
+
+  float s = sourceL[i0] + frac * (sourceL[i1] - sourceL[i0]);
+  if (sourceR != nullptr)
+    s = 0.5f * (s + sourceR[i0] + frac * (sourceR[i1] - sourceR[i0]));
+  return s;
+}
+
+void TimeStretcher::fillFrame(double sourcePosition, int numSamples) {
+  double pos = sourcePosition;
+  for (int i = 0; i < numSamples; ++i) {
+    frame[(size_t)i] = readSource(pos);
+    pos += resample;
+  }
+}
+
+int TimeStretcher::findBestOffset() const {
+  if (!hasContinuation)
+    return tolerance; // Nothing to align to yet: take the nominal frame
+
+  const int overlap = frameSize - hopSize;
+  const auto *target = continuation.data();
+  const auto *input = frame.data();
+
+  auto correlate = [&](int offset, int step) {
+    float sum = 0.0f;
+    for (int i = 0; i < overlap; i += step)
+      sum += input[offset + i] * target[i];
+    return sum;
+  };
+
+  // Coarse pass on a decimated grid, then refine around the winner
+  int best = tolerance;
+  float bestScore = correlate(best, 4);
+
+  for (int k = 0; k <= 2 * tolerance; k += 4) {
+    float score = correlate(k, 4);
+    if (score > bestScore) {
+      bestScore = score;
+      best = k;
+    }
+  }
+
+  const int coarse = best;
+  bestScore = correlate(coarse, 1);
+
+  for (int k = juce::jmax(0, coarse - 3);
+       k <= juce::jmin(2 * tolerance, coarse + 3); ++k) {
+    float score = correlate(k, 1);
+    if (score > bestScore) {
+      bestScore = score;
+      best = k;
+    }
+  }
+
+  return best;
+}
+
+void TimeStretcher::synthesiseHop() {
+  // 1. Resample the search region around the nominal position
+  fillFrame(nominalPosition - (double)tolerance * resample,
+            frameSize + 2 * tolerance);
+
+  // 2. Pick the frame that best continues the previous one
+  const int offset = findBestOffset();
+  const auto *chosen = frame.data() + offset;
+
+  // 3. Overlap-add
+  for (int i = 0; i < frameSize; ++i)
+    overlapAdd[(size_t)i] += chosen[i] * window[(size_t)i];
+
+  std::copy(overlapAdd.begin(), overlapAdd.begin() + hopSize, ready.begin());
+  std::copy(overlapAdd.begin() + hopSize, overlapAdd.end(),
+            overlapAdd.begin());
+  std::fill(overlapAdd.end() - hopSize, overlapAdd.end(), 0.0f);
+  readyPosition = 0;
+
+  // 4. What would naturally follow the chosen frame
+  std::copy(chosen + hopSize, chosen + frameSize, continuation.begin());
+  hasContinuation = true;
+
+  // 5. Advance the analysis position at the stretched rate
+  nominalPosition += (double)hopSize * speed * resample;
+  nominalPosition = std::fmod(nominalPosition, (double)loopLength);
+}
+
+void TimeStretcher::render(float *dest, int numSamples) {
+  if (sourceL == nullptr || loopLength < frameSize)
+    return;
+
+  int written = 0;
+  while (written < numSamples) {
+    if (readyPosition >= hopSize)
+      synthesiseHop();
+
+    const int count =
+        juce::jmin(numSamples - written, hopSize - readyPosition);
+    juce::FloatVectorOperations::add(dest + written,
+                                     ready.data() + readyPosition, count);
+    written += count;
+    readyPosition += count;
+  }
+}
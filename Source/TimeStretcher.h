@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Tempo and beat grid of a loop, computed once per file off the audio thread.
+*/
+struct LoopAnalysis {
+  double bpm = 120.0;
+  int numBeats = 4;
+  std::vector<int> beatPositions; // Sample index of each beat in the source
+
+  // Energy-flux onset detection + autocorrelation, snapped so the loop holds
+  // a whole number of beats. Safe to call from any thread.
+  static LoopAnalysis analyse(const juce::AudioBuffer<float> &data, int length,
+                              double sampleRate);
+};
+
+//==============================================================================
+/**
+    WSOLA time-stretcher for looped Sequence samples.
+
+    Changes playback speed without changing pitch. Each output hop picks the
+    input frame (within a small search window) that best lines up with the
+    natural continuation of the previous frame, then overlap-adds it with a
+    Hann window. Output is generated one hop ahead of the read position, which
+    is the look-ahead buffer.
+*/
+class TimeStretcher {
+public:
+  TimeStretcher();
+
+  void prepare(double sampleRate);
+  void reset();
+
+  // resampleRatio = source rate / host rate. startPosition in source samples.
+  void start(const juce::AudioBuffer<float> &source, int sourceLength,
+             double resampleRatio, int startPosition = 0);
+
+  // 1.0 = recorded tempo, 2.0 = twice as fast
+  void setSpeed(double newSpeed) { speed = juce::jlimit(0.25, 4.0, newSpeed); }
+
+  // Adds the stretched (mono) loop to dest.
+  void render(float *dest, int numSamples);
+
+private:
+  void synthesiseHop();
+  void fillFrame(double sourcePosition, int numSamples);
+  int findBestOffset() const;
+  float readSource(double position) const;
+
+  int frameSize = 1024; // N
+  int hopSize = 512;    // Ha (50% overlap)
+  int tolerance = 256;  // Search range either side of the nominal position
+
+  std::vector<float> window;
+  std::vector<float> frame;        // Resampled input, N + 2 * tolerance
+  std::vector<float> continuation; // Natural continuation of the last frame
+  std::vector<float> overlapAdd;   // N
+  std::vector<float> ready;        // One finished hop
+  int readyPosition = 0;
+  bool hasContinuation = false;
+
+  const float *sourceL = nullptr;
+  const float *sourceR = nullptr;
+  int loopLength = 0;
+
+  double nominalPosition = 0.0; // Source samples
+  double resample = 1.0;
+  double speed = 1.0;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretcher)
+};
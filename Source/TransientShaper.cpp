@@ -1,83 +1,158 @@
 #include "TransientShaper.h"
 
-TransientShaper::TransientShaper() {}
-
 void TransientShaper::prepare(const juce::dsp::ProcessSpec &spec) {
-  sampleRate = (float)spec.sampleRate;
+  sampleRate = spec.sampleRate;
+  numChannels = juce::jlimit(1, 2, (int)spec.numChannels);
+  maxBlockSize = juce::jmax(1, (int)spec.maximumBlockSize);
+
+  // Fast follower shared by both differences: attack pair (same release),
+  // sustain pair (same attack)
+  fast.setTimes(2.0f, 50.0f, sampleRate);
+  slowAttack.setTimes(20.0f, 50.0f, sampleRate);
+  slowRelease.setTimes(2.0f, 300.0f, sampleRate);
 
-  fastEnvs.resize(spec.numChannels);
-  slowEnvs.resize(spec.numChannels);
+  attack.prepare(sampleRate, smoothingSeconds);
+  sustain.prepare(sampleRate, smoothingSeconds);
+  mix.prepare(sampleRate, smoothingSeconds);
 
-  setAttackSpeed(fastAttackMs, slowAttackMs);
+  attackCurve.resize((size_t)maxBlockSize);
+  ramp.resize((size_t)maxBlockSize);
+  sustainCurve.resize((size_t)maxBlockSize);
+  gain.resize((size_t)maxBlockSize);
+  history.setSize(numChannels,
+                  getLookaheadSamples(maxLookaheadMs, sampleRate) +
+                      maxBlockSize);
   reset();
 }
 
 void TransientShaper::reset() {
-  for (auto &env : fastEnvs)
-    env.reset();
-  for (auto &env : slowEnvs)
-    env.reset();
+  fast.value = slowAttack.value = slowRelease.value = 0.0f;
+  history.clear();
+  lookahead = getLookaheadSamples(params.lookaheadMs, sampleRate);
+
+  // Land on the targets rather than gliding in from stale values
+  attack.snapToTarget();
+  sustain.snapToTarget();
+  mix.snapToTarget();
 }
 
-void TransientShaper::setAttackSpeed(float fastMs, float slowMs) {
-  fastAttackMs = fastMs;
-  slowAttackMs = slowMs;
+void TransientShaper::setParameters(const Parameters &newParams) {
+  params = newParams;
+  attack.setTarget(juce::jlimit(-1.0f, 1.0f, params.attack));
+  sustain.setTarget(juce::jlimit(-1.0f, 1.0f, params.sustain));
+}
 
-  for (auto &env : fastEnvs)
-    env.setCoefficients(fastAttackMs, releaseMs, sampleRate);
-  for (auto &env : slowEnvs)
-    env.setCoefficients(slowAttackMs, releaseMs, sampleRate);
+int TransientShaper::getLookaheadSamples(float lookaheadMs, double rate) {
+  if (lookaheadMs <= 0.0f)
+    return 0;
+  return juce::roundToInt(juce::jmin(lookaheadMs, maxLookaheadMs) * rate *
+                          0.001);
 }
 
 void TransientShaper::process(juce::AudioBuffer<float> &buffer) {
-  // Always process if smoothing or active
-  if (std::abs(biteAmount.getCurrentValue()) < 0.01f &&
-      !biteAmount.isSmoothing() &&
-      std::abs(biteAmount.getTargetValue()) < 0.01f)
+  const int numSamples = buffer.getNumSamples();
+  const int channels = juce::jmin(buffer.getNumChannels(), numChannels);
+  if (numSamples == 0 || channels == 0 || gain.empty())
     return;
 
-  auto numChannels = buffer.getNumChannels();
-  auto numSamples = buffer.getNumSamples();
-
-  // Resize safety
-  if (fastEnvs.size() != numChannels) {
-    fastEnvs.resize(numChannels);
-    slowEnvs.resize(numChannels);
-    setAttackSpeed(fastAttackMs, slowAttackMs);
-    // Reset envs
-    for (auto &env : fastEnvs)
-      env.reset();
-    for (auto &env : slowEnvs)
-      env.reset();
+  // A look-ahead change restarts the delay (a click, like any latency
+  // change; the host re-aligns once the new latency is reported)
+  const int newLookahead = getLookaheadSamples(params.lookaheadMs, sampleRate);
+  if (newLookahead != lookahead) {
+    lookahead = newLookahead;
+    history.clear();
+  }
+
+  std::array<float *, 2> pointers{};
+  for (int start = 0; start < numSamples; start += maxBlockSize) {
+    for (int ch = 0; ch < channels; ++ch)
+      pointers[(size_t)ch] = buffer.getWritePointer(ch, start);
+    processChunk(pointers.data(), channels,
+                 juce::jmin(maxBlockSize, numSamples - start));
   }
+}
+
+void TransientShaper::processChunk(float *const *channels, int channelCount,
+                                   int numSamples) {
+  using FVO = juce::FloatVectorOperations;
+
+  // One smoothing step per block, ramped linearly across it
+  attack.next(numSamples);
+  sustain.next(numSamples);
+  mix.next(numSamples);
 
-  auto *ch0 = buffer.getWritePointer(0);
-  auto *ch1 = (numChannels > 1) ? buffer.getWritePointer(1) : nullptr;
+  const bool flat = std::abs(attack.getStart()) < 1.0e-4f &&
+                    std::abs(attack.getEnd()) < 1.0e-4f &&
+                    std::abs(sustain.getStart()) < 1.0e-4f &&
+                    std::abs(sustain.getEnd()) < 1.0e-4f;
+  if (flat || (mix.getStart() < 1.0e-4f && mix.getEnd() < 1.0e-4f)) {
+    // Nothing to shape: the look-ahead delay still runs so the reported
+    // latency holds
+    idle = true;
+    for (int ch = 0; ch < channelCount; ++ch)
+      delay(ch, channels[ch], numSamples);
+    return;
+  }
+  if (idle) {
+    fast.value = slowAttack.value = slowRelease.value = 0.0f;
+    idle = false;
+  }
 
+  auto *attackDiff = attackCurve.data();
+  auto *sustainDiff = sustainCurve.data();
+  auto *g = gain.data();
+
+  // 1. Linked detector: the louder channel (vector)
+  FVO::abs(attackDiff, channels[0], numSamples);
+  for (int ch = 1; ch < channelCount; ++ch) {
+    FVO::abs(sustainDiff, channels[ch], numSamples);
+    FVO::max(attackDiff, attackDiff, sustainDiff, numSamples);
+  }
+
+  // 2. Followers (the only recursive part), once for both channels
   for (int i = 0; i < numSamples; ++i) {
-    float bite = biteAmount.getNextValue();
-
-    // Ch 0
-    {
-      float input = ch0[i];
-      float fast = fastEnvs[0].process(input);
-      float slow = slowEnvs[0].process(input);
-      float transient = fast - slow;
-      // Boosted intensity for more noticeable "Bite"
-      float gainChange = 1.0f + (transient * bite * 6.0f);
-      gainChange = juce::jlimit(0.1f, 4.0f, gainChange);
-      ch0[i] = input * gainChange;
-    }
-
-    // Ch 1
-    if (ch1) {
-      float input = ch1[i];
-      float fast = fastEnvs[1].process(input);
-      float slow = slowEnvs[1].process(input);
-      float transient = fast - slow;
-      float gainChange = 1.0f + (transient * bite * 6.0f);
-      gainChange = juce::jlimit(0.1f, 4.0f, gainChange);
-      ch1[i] = input * gainChange;
-    }
+    const float level = attackDiff[i];
+    const float f = fast.process(level);
+    attackDiff[i] = f - slowAttack.process(level);
+    sustainDiff[i] = slowRelease.process(level) - f;
   }
+
+  // 3. Gain curve, g = 6 (attack * attackDiff + sustain * sustainDiff)
+  //    (vector). The 6x scaling and the 0.1 - 4 range are the original
+  //    BITE voicing.
+  auto *r = ramp.data();
+  if (attack.fill(r, numSamples, 6.0f))
+    FVO::multiply(g, attackDiff, r, numSamples);
+  else
+    FVO::multiply(g, attackDiff, 6.0f * attack.getEnd(), numSamples);
+  if (sustain.fill(r, numSamples, 6.0f))
+    FVO::addWithMultiply(g, sustainDiff, r, numSamples);
+  else
+    FVO::addWithMultiply(g, sustainDiff, 6.0f * sustain.getEnd(), numSamples);
+  FVO::clip(g, g, -0.9f, 3.0f, numSamples); // gain - 1
+
+  // 4. Slot mix folds into the gain: dry + (wet - dry) * m = x * (1 + g * m)
+  if (mix.fill(r, numSamples))
+    FVO::multiply(g, r, numSamples);
+  else
+    FVO::multiply(g, mix.getEnd(), numSamples);
+  FVO::add(g, 1.0f, numSamples);
+
+  // 5. Delay the audio behind the detector and apply
+  for (int ch = 0; ch < channelCount; ++ch) {
+    delay(ch, channels[ch], numSamples);
+    FVO::multiply(channels[ch], g, numSamples);
+  }
+}
+
+void TransientShaper::delay(int channel, float *data, int numSamples) {
+  if (lookahead == 0)
+    return;
+
+  // history = [last lookahead samples | this block]; the first numSamples
+  // of it are the delayed block, the last lookahead samples carry over
+  auto *line = history.getWritePointer(channel);
+  juce::FloatVectorOperations::copy(line + lookahead, data, numSamples);
+  juce::FloatVectorOperations::copy(data, line, numSamples);
+  std::memmove(line, line + numSamples, sizeof(float) * (size_t)lookahead);
 }
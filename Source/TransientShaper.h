@@ -1,58 +1,99 @@
 #pragma once
+#include "BlockRamp.h"
 #include <JuceHeader.h>
+#include <array>
+#include <vector>
 
+//==============================================================================
+/**
+    Stereo-linked transient shaper (the BITE section).
+
+    One detector drives both channels: it follows the louder channel, so a
+    hit gets the same gain on the left and the right and the image does not
+    shift. Three one-pole followers run on that detector:
+      - attack  = fast - slow-attack  (positive while a hit is rising)
+      - sustain = slow-release - fast (positive while a note is decaying)
+    Attack and sustain amounts scale these two into one gain curve.
+
+    Only the followers are recursive, so only they run one sample at a time,
+    and only once per block instead of once per channel. The detector, the
+    gain curve, its clip and its application are vector operations over the
+    whole block; the amounts enter as BlockRamp arrays while they move and
+    as scalars once they settle.
+
+    With look-ahead on, the audio is delayed by 1 - 5 ms and the detector
+    reads the undelayed input, so the attack boost lands on the transient
+    instead of just after it. The delay is reported by the processor as
+    latency. The slot mix is applied here against the same delayed signal,
+    so a partly wet shaper does not comb.
+*/
 class TransientShaper {
 public:
-  TransientShaper();
+  struct Parameters {
+    float attack = 0.0f;      // -1 (soften) - 1 (punch)
+    float sustain = 0.0f;     // -1 (tighten) - 1 (bloom)
+    float lookaheadMs = 0.0f; // 0 = off, up to maxLookaheadMs
+  };
+
+  static constexpr float maxLookaheadMs = 5.0f;
+
+  TransientShaper() = default;
 
   void prepare(const juce::dsp::ProcessSpec &spec);
   void reset();
 
-  // Process a block
+  void setParameters(const Parameters &newParams);
+  // Slot wet / dry from the effects graph
+  void setMix(float newMix) { mix.setTarget(juce::jlimit(0.0f, 1.0f, newMix)); }
   void process(juce::AudioBuffer<float> &buffer);
 
-  // Parameters
-  // Amount: -1.0 (Soften) to 1.0 (Punch)
-  void setAmount(float amount) { biteAmount.setTargetValue(amount); }
-
-  // Speed definitions (optional control)
-  void setAttackSpeed(float fastMs, float slowMs);
+  // Delay a look-ahead time adds, in samples (any thread)
+  static int getLookaheadSamples(float lookaheadMs, double rate);
+  int getLatencySamples() const { return lookahead; }
 
 private:
-  float sampleRate = 44100.0f;
-  juce::LinearSmoothedValue<float> biteAmount;
+  static constexpr double smoothingSeconds = 0.05;
 
-  // Envelope followers
-  // We can use simple one-pole filters for envelopes logic
-  // env = prev + coeff * (in - prev)
-
-  struct EnvelopeFollower {
+  struct Follower {
     float value = 0.0f;
     float attackCoeff = 0.0f;
     float releaseCoeff = 0.0f;
 
-    void setCoefficients(float attackMs, float releaseMsArg, float sr) {
-      attackCoeff = std::exp(-1000.0f / (attackMs * sr));
-      releaseCoeff = std::exp(-1000.0f / (releaseMsArg * sr));
+    void setTimes(float attackMs, float releaseMs, double rate) {
+      attackCoeff = (float)std::exp(-1000.0 / (attackMs * rate));
+      releaseCoeff = (float)std::exp(-1000.0 / (releaseMs * rate));
     }
 
     float process(float input) {
-      float absIn = std::abs(input);
-      if (absIn > value)
-        value = attackCoeff * value + (1.0f - attackCoeff) * absIn;
-      else
-        value = releaseCoeff * value + (1.0f - releaseCoeff) * absIn;
+      const float coeff = input > value ? attackCoeff : releaseCoeff;
+      value = input + coeff * (value - input);
       return value;
     }
-
-    void reset() { value = 0.0f; }
   };
 
-  // Per-channel state
-  std::vector<EnvelopeFollower> fastEnvs;
-  std::vector<EnvelopeFollower> slowEnvs;
+  void processChunk(float *const *channels, int channelCount, int numSamples);
+  // Pushes numSamples through the look-ahead delay of one channel
+  void delay(int channel, float *data, int numSamples);
+
+  Parameters params;
+  double sampleRate = 44100.0;
+  int numChannels = 2;
+  int maxBlockSize = 0;
+
+  // Linked detector
+  Follower fast, slowAttack, slowRelease;
+
+  // Smoothed settings
+  BlockRamp attack, sustain, mix{1.0f};
+  bool idle = true;
+
+  // Look-ahead: per channel, the last lookahead samples followed by the
+  // block being processed
+  int lookahead = 0;
+  juce::AudioBuffer<float> history;
+
+  // Per-block work (prepare)
+  std::vector<float> attackCurve, sustainCurve, gain, ramp;
 
-  float fastAttackMs = 2.0f;
-  float slowAttackMs = 20.0f; // Difference defines transient width
-  float releaseMs = 100.0f;   // Generally longer
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TransientShaper)
 };
@@ -0,0 +1,160 @@
+#include "VoiceFilter.h"
+
+namespace {
+// Antiderivative of tanh: log(cosh(x)), written so it cannot overflow
+inline float logCosh(float x) {
+  const float ax = std::abs(x);
+  return ax + std::log1p(std::exp(-2.0f * ax)) - 0.69314718f; // ln(2)
+}
+} // namespace
+
+VoiceFilter::VoiceFilter() {
+  using OS = juce::dsp::Oversampling<float>;
+  oversampler2x = std::make_unique<OS>(
+      1, 1, OS::filterHalfBandPolyphaseIIR, false);
+  oversampler4x = std::make_unique<OS>(
+      1, 2, OS::filterHalfBandPolyphaseIIR, false);
+}
+
+void VoiceFilter::prepare(double newSampleRate, int samplesPerBlock) {
+  sampleRate = newSampleRate;
+  oversampler2x->initProcessing((size_t)samplesPerBlock);
+  oversampler4x->initProcessing((size_t)samplesPerBlock);
+  reset();
+}
+
+void VoiceFilter::reset() {
+  oversamplingOrder = nextOversamplingOrder;
+  ic1eq = ic2eq = 0.0f;
+  lastX = lastF = 0.0f;
+  oversampler2x->reset();
+  oversampler4x->reset();
+}
+
+void VoiceFilter::setResonance(float resonance) {
+  resonanceAmount = juce::jlimit(0.0f, 1.0f, resonance);
+  // Same Q range as FilterProcessor: 0.5 .. 10
+  k = 1.0f / (0.5f + resonanceAmount * 9.5f);
+  updateOversampling();
+}
+
+void VoiceFilter::setDrive(float newDrive) {
+  drive = juce::jlimit(0.0f, 1.0f, newDrive);
+  driveGain = 1.0f + drive * 15.0f;
+  driveMakeup = 1.0f / std::sqrt(driveGain);
+  updateOversampling();
+}
+
+void VoiceFilter::setQuality(int newQuality) {
+  quality = (Quality)juce::jlimit(0, 2, newQuality);
+  updateOversampling();
+}
+
+void VoiceFilter::updateOversampling() {
+  // Only the nonlinear / screaming cases alias audibly
+  const bool needsOversampling = drive > 0.01f || resonanceAmount > 0.6f;
+
+  int order = 0;
+  if (needsOversampling) {
+    if (quality == Quality::Standard)
+      order = 1;
+    else if (quality == Quality::High)
+      order = 2;
+  }
+
+  // Applied by the next reset(), so a sounding note keeps its factor
+  nextOversamplingOrder = order;
+}
+
+float VoiceFilter::saturate(float x) {
+  x *= driveGain;
+
+  const float f = logCosh(x);
+  const float dx = x - lastX;
+
+  float y;
+  if (std::abs(dx) > 1.0e-4f)
+    y = (f - lastF) / dx;
+  else
+    y = std::tanh(0.5f * (x + lastX)); // Ill-conditioned: use the midpoint
+
+  lastX = x;
+  lastF = f;
+
+  // Rough make-up so drive adds grit rather than level
+  return y * driveMakeup;
+}
+
+void VoiceFilter::processBlock(float *data, const float *cutoffHz,
+                               int numSamples, int factor) {
+  const double rate = sampleRate * (double)factor;
+  const float maxCutoff = (float)juce::jmin(20000.0, rate * 0.45);
+  const bool useDrive = drive > 0.01f;
+
+  // Coefficients only move with the cutoff: at most one update per
+  // base-rate sample, none while the cutoff holds still
+  float fc = -1.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float newFc =
+        juce::jlimit(20.0f, maxCutoff, cutoffHz[i / factor]);
+    if (newFc != fc) {
+      fc = newFc;
+      const float g =
+          std::tan(juce::MathConstants<float>::pi * fc / (float)rate);
+      a1 = 1.0f / (1.0f + g * (g + k));
+      a2 = g * a1;
+      a3 = g * a2;
+    }
+
+    float v0 = useDrive ? saturate(data[i]) : data[i];
+
+    const float v3 = v0 - ic2eq;
+    const float v1 = a1 * ic1eq + a2 * v3;
+    const float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+    ic1eq = 2.0f * v1 - ic1eq;
+    ic2eq = 2.0f * v2 - ic2eq;
+
+    switch (type) {
+    default:
+    case 0:
+      data[i] = v2;
+      break;
+    case 1:
+      data[i] = v0 - k * v1 - v2;
+      break;
+    case 2:
+      data[i] = k * v1; // Unity gain at the centre
+      break;
+    case 3:
+      data[i] = v0 - k * v1;
+      break;
+    }
+  }
+}
+
+void VoiceFilter::process(float *data, const float *cutoffHz,
+                          int numSamples) {
+  if (oversamplingOrder == 0) {
+    processBlock(data, cutoffHz, numSamples, 1);
+  } else {
+    auto &os = oversamplingOrder == 1 ? *oversampler2x : *oversampler4x;
+
+    float *channels[] = {data};
+    juce::dsp::AudioBlock<float> block(channels, 1, (size_t)numSamples);
+
+    auto upsampled = os.processSamplesUp(block);
+    processBlock(upsampled.getChannelPointer(0), cutoffHz,
+                 (int)upsampled.getNumSamples(), getOversamplingFactor());
+    os.processSamplesDown(block);
+  }
+
+  // Safety Check for NaN/Infinity
+  for (int i = 0; i < numSamples; ++i) {
+    if (std::isnan(data[i]) || std::isinf(data[i])) {
+      juce::FloatVectorOperations::clear(data, numSamples);
+      reset();
+      break;
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Per-voice state-variable filter with a nonlinear drive stage.
+
+    The drive uses first-order antiderivative anti-aliasing (ADAA) on tanh.
+    When the patch uses drive or high resonance, the filter can also run
+    inside 2x/4x polyphase IIR oversampling. The quality setting picks the
+    factor, so clean patches never pay for it. The factor is picked at
+    reset() (note start) and held for the note: switching it mid-note would
+    change the latency and the filter state and click.
+*/
+class VoiceFilter {
+public:
+  enum class Quality { Eco = 0, Standard, High };
+
+  VoiceFilter();
+
+  void prepare(double sampleRate, int samplesPerBlock);
+  void reset();
+
+  // 0 = LowPass, 1 = HighPass, 2 = BandPass, 3 = Notch
+  void setType(int filterType) { type = filterType; }
+  void setResonance(float resonance); // 0.0 - 1.0
+  void setDrive(float newDrive);      // 0.0 - 1.0
+  void setQuality(int newQuality);
+
+  // Filters data in place. cutoffHz holds one cutoff per input sample.
+  void process(float *data, const float *cutoffHz, int numSamples);
+
+  int getOversamplingFactor() const { return 1 << oversamplingOrder; }
+
+private:
+  // Works out the factor the next reset() will use
+  void updateOversampling();
+  void processBlock(float *data, const float *cutoffHz, int numSamples,
+                    int factor);
+  float saturate(float x);
+
+  std::unique_ptr<juce::dsp::Oversampling<float>> oversampler2x;
+  std::unique_ptr<juce::dsp::Oversampling<float>> oversampler4x;
+  int oversamplingOrder = 0; // 0 = 1x, 1 = 2x, 2 = 4x
+  int nextOversamplingOrder = 0;
+
+  double sampleRate = 44100.0;
+  int type = 0;
+  Quality quality = Quality::Standard;
+
+  float k = 2.0f; // 1 / Q
+  float resonanceAmount = 0.0f;
+  float drive = 0.0f;
+  float driveGain = 1.0f;
+  float driveMakeup = 1.0f;
+
+  // TPT SVF state
+  float ic1eq = 0.0f;
+  float ic2eq = 0.0f;
+
+  // ADAA state (previous pre-gained input and its antiderivative)
+  float lastX = 0.0f;
+  float lastF = 0.0f;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VoiceFilter)
+};
@@ -0,0 +1,232 @@
+#include "WavetableEngine.h"
+
+namespace {
+// YIN period estimate (cumulative mean normalised difference) on a window of
+// mono audio. Returns the period in samples, or 0 if nothing periodic found.
+double estimatePeriod(const float *x, int windowSize, int minPeriod,
+                      int maxPeriod) {
+  std::vector<float> diff((size_t)maxPeriod + 1, 0.0f);
+
+  for (int tau = 1; tau <= maxPeriod; ++tau) {
+    float sum = 0.0f;
+    for (int i = 0; i < windowSize; ++i) {
+      float d = x[i] - x[i + tau];
+      sum += d * d;
+    }
+    diff[(size_t)tau] = sum;
+  }
+
+  // Normalise
+  float running = 0.0f;
+  diff[0] = 1.0f;
+  for (int tau = 1; tau <= maxPeriod; ++tau) {
+    running += diff[(size_t)tau];
+    diff[(size_t)tau] =
+        running > 0.0f ? diff[(size_t)tau] * (float)tau / running : 1.0f;
+  }
+
+  // First dip below the threshold, else the global minimum
+  int best = -1;
+  for (int tau = minPeriod; tau < maxPeriod; ++tau) {
+    if (diff[(size_t)tau] < 0.15f &&
+        diff[(size_t)tau] <= diff[(size_t)tau + 1]) {
+      best = tau;
+      break;
+    }
+  }
+
+  if (best < 0) {
+    best = minPeriod;
+    for (int tau = minPeriod; tau <= maxPeriod; ++tau)
+      if (diff[(size_t)tau] < diff[(size_t)best])
+        best = tau;
+
+    if (diff[(size_t)best] > 0.5f)
+      return 0.0; // Noise: no usable period
+  }
+
+  // Parabolic refinement
+  if (best > minPeriod && best < maxPeriod) {
+    float a = diff[(size_t)best - 1], b = diff[(size_t)best],
+          c = diff[(size_t)best + 1];
+    float denom = a - 2.0f * b + c;
+    if (std::abs(denom) > 1.0e-9f)
+      return (double)best + 0.5 * (double)(a - c) / (double)denom;
+  }
+
+  return (double)best;
+}
+} // namespace
+
+//==============================================================================
+// Wavetable
+//==============================================================================
+
+std::unique_ptr<Wavetable>
+Wavetable::build(const juce::AudioBuffer<float> &source, int length,
+                 double sampleRate) {
+  length = juce::jmin(length, source.getNumSamples());
+
+  // 1. Mono mix
+  std::vector<float> mono((size_t)juce::jmax(length, 0));
+  const auto *l = source.getReadPointer(0);
+  const auto *r = source.getNumChannels() > 1 ? source.getReadPointer(1) : l;
+  for (int i = 0; i < length; ++i)
+    mono[(size_t)i] = 0.5f * (l[i] + r[i]);
+
+  // Playable range for slicing: 30 Hz .. 2 kHz fundamentals
+  const int minPeriod = juce::jmax(2, (int)(sampleRate / 2000.0));
+  const int maxPeriod = (int)(sampleRate / 30.0);
+  const int window = 2048;
+  const int span = window + maxPeriod + 1;
+
+  if (length < span * 2)
+    return nullptr;
+
+  // 2. Frame positions spread over the body of the sample (skip the attack)
+  const int first = length / 10;
+  const int last = length - span - maxPeriod;
+  if (last <= first)
+    return nullptr;
+
+  auto table = std::make_unique<Wavetable>();
+  table->data.assign((size_t)maxFrames * numMipLevels * (tableSize + 1), 0.0f);
+
+  juce::dsp::FFT fft(11); // 2048 points
+  static_assert(tableSize == 2048, "FFT order must match the table size");
+  std::vector<float> spectrum((size_t)tableSize * 2);
+  std::vector<float> cycle((size_t)tableSize);
+
+  float peak = 0.0f;
+  std::vector<double> periods;
+  periods.reserve((size_t)maxFrames);
+
+  for (int f = 0; f < maxFrames; ++f) {
+    int pos = first + (int)((double)(last - first) * f / (maxFrames - 1));
+
+    double period =
+        estimatePeriod(mono.data() + pos, window, minPeriod, maxPeriod);
+    if (period <= 0.0)
+      continue;
+    periods.push_back(period);
+
+    // 3. Start on an upward zero crossing so the cycle joins cleanly
+    int start = pos;
+    for (int i = pos; i < pos + (int)period; ++i) {
+      if (mono[(size_t)i] <= 0.0f && mono[(size_t)i + 1] > 0.0f) {
+        start = i;
+        break;
+      }
+    }
+
+    // 4. Resample one period to the table size
+    for (int i = 0; i < tableSize; ++i) {
+      double p = (double)start + period * (double)i / (double)tableSize;
+      int idx = (int)p;
+      float frac = (float)(p - (double)idx);
+      cycle[(size_t)i] = mono[(size_t)idx] +
+                         frac * (mono[(size_t)idx + 1] - mono[(size_t)idx]);
+    }
+
+    // 5. Band-limit one copy per mip level
+    const int frame = table->numFrames++;
+
+    for (int level = 0; level < numMipLevels; ++level) {
+      std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+      std::copy(cycle.begin(), cycle.end(), spectrum.begin());
+      fft.performRealOnlyForwardTransform(spectrum.data());
+
+      // Drop DC and everything above this level's harmonic limit (both
+      // halves, whichever the FFT implementation filled in)
+      const int maxHarmonic = (tableSize / 2) >> level;
+      spectrum[0] = spectrum[1] = 0.0f;
+      for (int bin = maxHarmonic + 1; bin < tableSize - maxHarmonic; ++bin)
+        spectrum[(size_t)bin * 2] = spectrum[(size_t)bin * 2 + 1] = 0.0f;
+
+      fft.performRealOnlyInverseTransform(spectrum.data());
+
+      auto *dest = table->getWritableTable(frame, level);
+      std::copy(spectrum.begin(), spectrum.begin() + tableSize, dest);
+      dest[tableSize] = dest[0];
+
+      if (level == 0)
+        for (int i = 0; i < tableSize; ++i)
+          peak = juce::jmax(peak, std::abs(dest[i]));
+    }
+  }
+
+  if (table->numFrames == 0 || peak <= 0.0f)
+    return nullptr;
+
+  auto median = periods.begin() + (std::ptrdiff_t)(periods.size() / 2);
+  std::nth_element(periods.begin(), median, periods.end());
+  table->cycleHz = sampleRate / *median;
+
+  // 6. Normalise the whole set together so frames keep their relative level
+  juce::FloatVectorOperations::multiply(
+      table->data.data(), 1.0f / peak,
+      (int)((size_t)table->numFrames * numMipLevels * (tableSize + 1)));
+
+  return table;
+}
+
+//==============================================================================
+// WavetableOscillator
+//==============================================================================
+
+void WavetableOscillator::start(const Wavetable &newTable,
+                                double frequencyHz) {
+  table = &newTable;
+  phase = 0.0;
+  currentPosition = targetPosition;
+  setFrequency(frequencyHz);
+}
+
+void WavetableOscillator::setFrequency(double frequencyHz) {
+  increment = frequencyHz / sampleRate;
+
+  // Level m is alias-free while (1024 >> m) * f < Nyquist
+  const double harmonicsNeeded = (double)Wavetable::tableSize * increment;
+  mipLevel = 0;
+  while (mipLevel < Wavetable::numMipLevels - 1 &&
+         (double)((Wavetable::tableSize / 2) >> mipLevel) * harmonicsNeeded >
+             (double)(Wavetable::tableSize / 2))
+    ++mipLevel;
+}
+
+void WavetableOscillator::render(float *dest, int numSamples) {
+  if (table == nullptr || table->numFrames == 0 || numSamples <= 0)
+    return;
+
+  const int lastFrame = table->numFrames - 1;
+  const float positionStep =
+      (targetPosition - currentPosition) / (float)numSamples;
+  const double size = (double)Wavetable::tableSize;
+
+  float position = currentPosition;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float framePos = position * (float)lastFrame;
+    const int frameA = juce::jmin((int)framePos, lastFrame);
+    const int frameB = juce::jmin(frameA + 1, lastFrame);
+    const float frameMix = framePos - (float)frameA;
+
+    const auto *a = table->getTable(frameA, mipLevel);
+    const auto *b = table->getTable(frameB, mipLevel);
+
+    const double p = phase * size;
+    const int idx = (int)p;
+    const float frac = (float)(p - (double)idx);
+
+    const float sa = a[idx] + frac * (a[idx + 1] - a[idx]);
+    const float sb = b[idx] + frac * (b[idx + 1] - b[idx]);
+    dest[i] += sa + frameMix * (sb - sa);
+
+    phase += increment;
+    if (phase >= 1.0)
+      phase -= 1.0;
+    position += positionStep;
+  }
+
+  currentPosition = targetPosition;
+}
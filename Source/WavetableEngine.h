@@ -0,0 +1,71 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+    A set of single-cycle frames sliced out of a sample, each stored as a
+    band-limited mip-map (one table per octave of playable pitch).
+*/
+struct Wavetable {
+  static constexpr int tableSize = 2048;
+  static constexpr int numMipLevels = 11; // Level m keeps 1024 >> m harmonics
+  static constexpr int maxFrames = 32;
+
+  int numFrames = 0;
+
+  // Pitch the sample was recorded at (median of the sliced periods), so a
+  // voice plays it at the same pitch the sample path would
+  double cycleHz = 0.0;
+
+  // Table for one frame/level. Has tableSize + 1 points (wrap guard).
+  const float *getTable(int frame, int level) const {
+    return data.data() +
+           ((size_t)frame * numMipLevels + (size_t)level) * (tableSize + 1);
+  }
+
+  // Pitch-synchronous analysis of a loaded sample. Slow (FFTs, YIN period
+  // search): call it from a worker thread. Returns nullptr if no stable pitch
+  // was found.
+  static std::unique_ptr<Wavetable> build(const juce::AudioBuffer<float> &data,
+                                          int length, double sampleRate);
+
+private:
+  float *getWritableTable(int frame, int level) {
+    return data.data() +
+           ((size_t)frame * numMipLevels + (size_t)level) * (tableSize + 1);
+  }
+
+  std::vector<float> data;
+};
+
+//==============================================================================
+/**
+    Cheap per-voice oscillator that scans through the frames of a Wavetable.
+    Picks the mip level from the pitch so playback stays alias-free.
+*/
+class WavetableOscillator {
+public:
+  void prepare(double newSampleRate) { sampleRate = newSampleRate; }
+
+  void start(const Wavetable &newTable, double frequencyHz);
+  void setFrequency(double frequencyHz);
+
+  // 0.0 - 1.0 across the frames; ramps over the next rendered block
+  void setPosition(float newPosition) {
+    targetPosition = juce::jlimit(0.0f, 1.0f, newPosition);
+  }
+
+  // Adds the oscillator output to dest.
+  void render(float *dest, int numSamples);
+
+private:
+  const Wavetable *table = nullptr;
+  double sampleRate = 44100.0;
+  double phase = 0.0;
+  double increment = 0.0;
+  int mipLevel = 0;
+
+  float currentPosition = 0.0f;
+  float targetPosition = 0.0f;
+};